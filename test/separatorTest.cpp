@@ -3,6 +3,27 @@
 
 #include <boost/test/unit_test.hpp>
 #include <treeDAG/separatorCache.hpp>
+#include <treeDAG/bitsetSeparator.hpp>
+#include <treeDAG/smallSeparatorGenerator.hpp>
+#include <treeDAG/minimalSeparatorGenerator.hpp>
+#include <treeDAG/graphReducer.hpp>
+#include <treeDAG/atomDecomposer.hpp>
+#include <treeDAG/vertexOrdering.hpp>
+#include <treeDAG/treewidthBound.hpp>
+#include <treeDAG/iterativeDecomposer.hpp>
+#include <treeDAG/util/nChooseKIterator.hpp>
+#include <treeDAG/util/combinationIterator.hpp>
+#include <boost/graph/graph_concepts.hpp>
+#include <boost/thread.hpp>
+#include <boost/bind.hpp>
+#include <algorithm>
+#include <set>
+#include <sstream>
+#include <string>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
 
 #include "util.hpp"
 
@@ -65,3 +86,1370 @@ BOOST_AUTO_TEST_CASE( cycle_test )
 
 }
 
+
+namespace {
+
+std::set<std::vector<std::size_t> > separatorSet(const treeDAG::SeparatorCache & cache)
+{
+    std::set<std::vector<std::size_t> > result;
+    for(std::pair<treeDAG::SeparatorCache::SeparatorIterator, treeDAG::SeparatorCache::SeparatorIterator> p = cache.separators(); p.first != p.second; ++p.first)
+        result.insert(std::vector<size_t>(p.first->separator().first, p.first->separator().second));
+
+    return result;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE( minimal_separator_generation_test )
+{
+    std::vector<Graph> graphs;
+    graphs.push_back(make_path(7));
+    graphs.push_back(make_cycle(8));
+    graphs.push_back(make_grid(3, 4));
+
+    for(std::size_t i = 0; i < graphs.size(); ++i)
+        for(std::size_t k = 1; k <= 3; ++k)
+        {
+            treeDAG::SeparatorCache bruteForce(k, &graphs[i]);
+            bruteForce.initialize();
+
+            treeDAG::SeparatorCache generated(k, &graphs[i]);
+            generated.setInitializationMethod(treeDAG::SeparatorCache::INIT_MinimalSeparatorGeneration);
+            generated.initialize();
+
+            BOOST_CHECK(separatorSet(bruteForce) == separatorSet(generated));
+        }
+
+    // the closure gives up when it needs more separations per separator found than allowed: the
+    // grid needs 6 for its separators of three vertices, but 96 for the four of two vertices
+    treeDAG::CSRGraph csr(graphs[2]);
+    std::vector<std::vector<std::size_t> > separators;
+    BOOST_CHECK(treeDAG::MinimalSeparatorGenerator(&csr).generate(3, separators));
+    BOOST_CHECK(!separators.empty());
+    BOOST_CHECK(treeDAG::MinimalSeparatorGenerator(&csr).generate(3, separators, 6));
+    BOOST_CHECK(!treeDAG::MinimalSeparatorGenerator(&csr).generate(3, separators, 5));
+    BOOST_CHECK(!treeDAG::MinimalSeparatorGenerator(&csr).generate(2, separators, treeDAG::SeparatorCache::ClosureSeparationsPerSeparator));
+
+    // so the cache keeps the closure at k = 3 and falls back to the brute force method at k = 2, the
+    // closure is timed either way
+    for(std::size_t k = 2; k <= 3; ++k)
+    {
+        treeDAG::SeparatorCache generated(k, &csr);
+        generated.setInitializationMethod(treeDAG::SeparatorCache::INIT_MinimalSeparatorGeneration);
+        generated.initialize();
+
+        const treeDAG::SeparatorCache::InitializationStatistics & statistics = generated.statistics();
+        BOOST_CHECK_EQUAL(statistics.threads.size(), k == 3 ? 1u : 2u);
+        BOOST_CHECK(statistics.threads.front().time.count() > 0);
+    }
+}
+
+BOOST_AUTO_TEST_CASE( parallel_initialization_test )
+{
+    Graph g = make_grid(3, 4);
+
+    for(std::size_t k = 1; k <= 3; ++k)
+    {
+        treeDAG::SeparatorCache sequential(k, &g);
+        sequential.initialize();
+
+        treeDAG::SeparatorCache parallel(k, &g);
+        parallel.setNumberOfThreads(4);
+        parallel.initialize();
+
+        BOOST_CHECK(separatorSet(sequential) == separatorSet(parallel));
+        BOOST_REQUIRE_EQUAL(parallel.statistics().threads.size(), 4u);
+
+        std::size_t candidates = 0;
+        for(std::size_t i = 0; i < 4; ++i)
+            candidates += parallel.statistics().threads[i].candidates;
+        BOOST_CHECK_EQUAL(candidates, sequential.statistics().threads[0].candidates);
+    }
+}
+
+template <typename Word>
+void checkBitsetSeparator(const Graph & g, const std::vector<std::size_t> & separator)
+{
+    treeDAG::Separation expected = treeDAG::Separator(&g)(separator.begin(), separator.end());
+    treeDAG::Separation actual = treeDAG::BitsetSeparator<Word>(&g)(separator.begin(), separator.end());
+
+    BOOST_CHECK(expected.separator == actual.separator);
+    BOOST_CHECK(expected.componentMap == actual.componentMap);
+    BOOST_CHECK(expected.components == actual.components);
+}
+
+BOOST_AUTO_TEST_CASE( bitset_separator_test )
+{
+    Graph g = make_grid(9, 17);
+
+    std::vector<std::size_t> separator;
+    for(std::size_t x = 0; x < 9; ++x)
+        separator.push_back(5 * 9 + x);
+    separator.push_back(12 * 9 + 4);
+
+    checkBitsetSeparator<boost::uint64_t>(g, separator);
+    checkBitsetSeparator<unsigned char>(g, separator);
+#if defined(__GNUC__)
+    checkBitsetSeparator<treeDAG::util::Word128>(g, separator);
+#endif
+
+    Graph small = make_grid(4, 5);
+    treeDAG::SeparatorCache adjacency(3, &small);
+    adjacency.setSeparatorKernel(treeDAG::SeparatorCache::KERNEL_Adjacency);
+    adjacency.initialize();
+
+    treeDAG::SeparatorCache bitset(3, &small);
+    bitset.setSeparatorKernel(treeDAG::SeparatorCache::KERNEL_Bitset);
+    bitset.initialize();
+
+    BOOST_CHECK(separatorSet(adjacency) == separatorSet(bitset));
+}
+
+BOOST_AUTO_TEST_CASE( minimal_separator_predicate_test )
+{
+    typedef treeDAG::util::NChooseKIterator<std::vector<std::size_t>::iterator> CombIter;
+
+    Graph g = make_grid(4, 4);
+    boost::add_edge(0, 5, g);
+    boost::add_edge(6, 9, g);
+
+    std::vector<std::size_t> vertices;
+    for(std::size_t i = 0; i < 16; ++i)
+        vertices.push_back(i);
+
+    treeDAG::Separator separator(&g);
+    treeDAG::BitsetSeparator<> bitsetSeparator(&g);
+    treeDAG::Separation separation;
+
+    for(std::size_t k = 1; k <= 4; ++k)
+        for(std::pair<CombIter, CombIter> p = treeDAG::util::make_n_choose_k_iterators(vertices.begin(), vertices.end(), k); p.first != p.second; ++p.first)
+        {
+            separator.separate(p.first->begin(), p.first->end(), separation);
+            separation.limitToMaximalComponents();
+            bool expected = separation.components.size() > 1;
+
+            BOOST_CHECK_EQUAL(expected, separator.isMinimalSeparator(p.first->begin(), p.first->end()));
+            BOOST_CHECK_EQUAL(expected, bitsetSeparator.isMinimalSeparator(p.first->begin(), p.first->end()));
+        }
+}
+
+void checkSmallSeparators(const Graph & g)
+{
+    typedef treeDAG::util::NChooseKIterator<std::vector<std::size_t>::iterator> CombIter;
+
+    std::vector<std::size_t> vertices;
+    for(std::size_t i = 0; i < boost::num_vertices(g); ++i)
+        vertices.push_back(i);
+
+    treeDAG::Separator separator(&g);
+    std::vector<std::vector<std::size_t> > expected;
+    for(std::size_t k = 1; k <= 2; ++k)
+        for(std::pair<CombIter, CombIter> p = treeDAG::util::make_n_choose_k_iterators(vertices.begin(), vertices.end(), k); p.first != p.second; ++p.first)
+            if(separator.isMinimalSeparator(p.first->begin(), p.first->end()))
+                expected.push_back(std::vector<std::size_t>(p.first->begin(), p.first->end()));
+
+    treeDAG::CSRGraph csr(g);
+    std::vector<std::vector<std::size_t> > actual;
+    treeDAG::SmallSeparatorGenerator(&csr).generate(2, actual);
+
+    std::sort(expected.begin(), expected.end());
+    std::sort(actual.begin(), actual.end());
+    BOOST_CHECK(expected == actual);
+}
+
+BOOST_AUTO_TEST_CASE( small_separator_test )
+{
+    checkSmallSeparators(make_grid(4, 5));
+    checkSmallSeparators(make_cycle(9));
+    checkSmallSeparators(make_path(7));
+
+    // two blocks sharing a vertex, a pendant path and a separate triangle
+    Graph g = make_grid(3, 3);
+    boost::add_vertex(g);
+    boost::add_vertex(g);
+    boost::add_edge(8, 9, g);
+    boost::add_edge(8, 10, g);
+    boost::add_edge(9, 10, g);
+    boost::add_vertex(g);
+    boost::add_edge(10, 11, g);
+    for(std::size_t i = 0; i < 3; ++i)
+        boost::add_vertex(g);
+    boost::add_edge(12, 13, g);
+    boost::add_edge(13, 14, g);
+    boost::add_edge(12, 14, g);
+    checkSmallSeparators(g);
+
+    // and the cache fills the small sizes from the generator
+    treeDAG::SeparatorCache generated(3, &g);
+    generated.setInitializationMethod(treeDAG::SeparatorCache::INIT_MinimalSeparatorGeneration);
+    generated.initialize();
+
+    treeDAG::SeparatorCache revolvingDoor(3, &g);
+    revolvingDoor.setInitializationMethod(treeDAG::SeparatorCache::INIT_RevolvingDoor);
+    revolvingDoor.initialize();
+
+    BOOST_CHECK(separatorSet(generated) == separatorSet(revolvingDoor));
+}
+
+BOOST_AUTO_TEST_CASE( csr_graph_test )
+{
+    Graph g = make_grid(4, 4);
+
+    std::vector<std::pair<std::size_t, std::size_t> > edges;
+    boost::graph_traits<Graph>::edge_iterator it, end;
+    for(boost::tie(it, end) = boost::edges(g); it != end; ++it)
+        edges.push_back(std::make_pair(boost::source(*it, g), boost::target(*it, g)));
+
+    treeDAG::CSRGraph csr = treeDAG::CSRGraph::fromEdges(16, edges.begin(), edges.end());
+    BOOST_CHECK_EQUAL(num_vertices(csr), 16u);
+    BOOST_CHECK_EQUAL(num_edges(csr), boost::num_edges(g));
+
+    // the out edges go from the vertex to its neighbours, in the order of the adjacency
+    BOOST_CONCEPT_ASSERT((boost::IncidenceGraphConcept<treeDAG::CSRGraph>));
+    BOOST_CONCEPT_ASSERT((boost::AdjacencyGraphConcept<treeDAG::CSRGraph>));
+    BOOST_CONCEPT_ASSERT((boost::VertexListGraphConcept<treeDAG::CSRGraph>));
+
+    std::size_t outEdges = 0;
+    for(std::size_t v = 0; v < 16; ++v)
+    {
+        treeDAG::CSRGraph::AdjacencyIterator adjIt = adjacent_vertices(v, csr).first;
+        for(std::pair<treeDAG::CSRGraph::OutEdgeIterator, treeDAG::CSRGraph::OutEdgeIterator> p = out_edges(v, csr); p.first != p.second; ++p.first, ++adjIt, ++outEdges)
+        {
+            BOOST_CHECK_EQUAL(source(*p.first, csr), v);
+            BOOST_CHECK_EQUAL(target(*p.first, csr), *adjIt);
+        }
+    }
+    BOOST_CHECK_EQUAL(outEdges, 2 * boost::num_edges(g));
+
+    // the same graph from the raw csr arrays
+    treeDAG::CSRGraph copy(csr.offsets().begin(), csr.offsets().end(), csr.targets().begin());
+
+    treeDAG::SeparatorCache listCache(2, &g);
+    listCache.initialize();
+
+    treeDAG::SeparatorCache csrCache(2, &copy);
+    csrCache.initialize();
+
+    BOOST_CHECK(separatorSet(listCache) == separatorSet(csrCache));
+
+    // malformed input is rejected before anything is written out of range
+    std::vector<std::pair<std::size_t, std::size_t> > outside(1, std::make_pair(0u, 16u));
+    std::vector<std::pair<std::size_t, std::size_t> > loop(1, std::make_pair(3u, 3u));
+    BOOST_CHECK_THROW(treeDAG::CSRGraph::fromEdges(16, outside.begin(), outside.end()), std::logic_error);
+    BOOST_CHECK_THROW(treeDAG::CSRGraph::fromEdges(16, loop.begin(), loop.end()), std::logic_error);
+
+    // a path 0 - 1 - 2, then with a target out of range, a decreasing offset, one direction and a self loop
+    const std::size_t offsets[] = { 0, 1, 3, 4 };
+    const std::size_t targets[] = { 1, 0, 2, 1 };
+    BOOST_CHECK_EQUAL(treeDAG::CSRGraph(offsets, offsets + 4, targets).numEdges(), 2u);
+
+    const std::size_t badTargets[] = { 1, 0, 3, 1 };
+    const std::size_t badOffsets[] = { 0, 3, 1, 4 };
+    const std::size_t oneWay[] = { 1, 0, 2, 0 };
+    const std::size_t loopTargets[] = { 1, 0, 1, 2 };
+    BOOST_CHECK_THROW(treeDAG::CSRGraph(offsets, offsets + 4, badTargets), std::logic_error);
+    BOOST_CHECK_THROW(treeDAG::CSRGraph(badOffsets, badOffsets + 4, targets), std::logic_error);
+    BOOST_CHECK_THROW(treeDAG::CSRGraph(offsets, offsets + 4, oneWay), std::logic_error);
+    BOOST_CHECK_THROW(treeDAG::CSRGraph(offsets, offsets + 4, loopTargets), std::logic_error);
+}
+
+BOOST_AUTO_TEST_CASE( separator_workspace_test )
+{
+    Graph g = make_grid(5, 5);
+    treeDAG::Separator separator(&g);
+
+    std::vector<std::vector<std::size_t> > candidates;
+    for(std::size_t i = 0; i < 5; ++i)
+    {
+        std::vector<std::size_t> candidate;
+        for(std::size_t j = 0; j <= i; ++j)
+            candidate.push_back(5 * j + i);
+        candidates.push_back(candidate);
+    }
+
+    // the batch results should not depend on what was in the output before
+    std::vector<treeDAG::Separation> batch(7, separator(candidates.back().begin(), candidates.back().end()));
+    separator.separateAll(candidates.begin(), candidates.end(), batch);
+    BOOST_REQUIRE_EQUAL(batch.size(), candidates.size());
+
+    for(std::size_t i = 0; i < candidates.size(); ++i)
+    {
+        treeDAG::Separation single = treeDAG::Separator(&g)(candidates[i].begin(), candidates[i].end());
+        BOOST_CHECK(single.separator == batch[i].separator);
+        BOOST_CHECK(single.componentMap == batch[i].componentMap);
+        BOOST_CHECK(single.components == batch[i].components);
+    }
+
+    // the bitset kernel should also overwrite a reused separation completely
+    treeDAG::BitsetSeparator<> bitset(&g);
+    treeDAG::Separation reused = batch.back();
+    for(std::size_t i = 0; i < candidates.size(); ++i)
+    {
+        bitset.separate(candidates[i].begin(), candidates[i].end(), reused);
+        BOOST_CHECK(batch[i].componentMap == reused.componentMap);
+        BOOST_CHECK(batch[i].components == reused.components);
+    }
+}
+
+BOOST_AUTO_TEST_CASE( subgraph_separator_test )
+{
+    const std::size_t S = treeDAG::SeparatorConfig::SeparatorVertex();
+
+    // inside the path 1..7 of the cycle, the middle vertex separates
+    Graph g = make_cycle(8);
+    treeDAG::Separator separator(&g);
+
+    std::vector<std::size_t> subgraph;
+    for(std::size_t i = 1; i < 8; ++i)
+        subgraph.push_back(i);
+    const std::size_t middle = 4;
+
+    BOOST_CHECK(separator.isMinimalSeparatorInSubgraph(subgraph.begin(), subgraph.end(), &middle, &middle + 1));
+    BOOST_CHECK(!separator.isMinimalSeparator(&middle, &middle + 1));
+
+    treeDAG::Separation separation;
+    separator.separateSubgraph(subgraph.begin(), subgraph.end(), &middle, &middle + 1, separation);
+
+    // the map is on the positions in the subgraph, the components on the vertices of the graph
+    const std::size_t expectedMap[] = { 0, 0, 0, S, 1, 1, 1 };
+    const std::size_t first[] = { 1, 2, 3, 4 }, second[] = { 4, 5, 6, 7 };
+    BOOST_CHECK(separation.separator == std::vector<std::size_t>(1, middle));
+    BOOST_CHECK(separation.componentMap == std::vector<std::size_t>(expectedMap, expectedMap + 7));
+    BOOST_REQUIRE_EQUAL(separation.components.size(), 2u);
+    BOOST_CHECK(separation.components[0] == std::vector<std::size_t>(first, first + 4));
+    BOOST_CHECK(separation.components[1] == std::vector<std::size_t>(second, second + 4));
+
+    // the separator should be inside the subgraph
+    const std::size_t outside = 0;
+    BOOST_CHECK_THROW(separator.separateSubgraph(subgraph.begin(), subgraph.end(), &outside, &outside + 1, separation), std::logic_error);
+
+    // and the whole graph again with the same scratch space
+    treeDAG::Separation whole = separator(&middle, &middle + 1);
+    BOOST_CHECK_EQUAL(whole.components.size(), 1u);
+    BOOST_CHECK_EQUAL(whole.componentMap.size(), 8u);
+}
+
+BOOST_AUTO_TEST_CASE( revolving_door_test )
+{
+    std::vector<Graph> graphs;
+    graphs.push_back(make_path(7));
+    graphs.push_back(make_cycle(8));
+    graphs.push_back(make_grid(3, 4));
+
+    for(std::size_t i = 0; i < graphs.size(); ++i)
+        for(std::size_t k = 1; k <= 3; ++k)
+        {
+            treeDAG::SeparatorCache bruteForce(k, &graphs[i]);
+            bruteForce.initialize();
+
+            treeDAG::SeparatorCache revolvingDoor(k, &graphs[i]);
+            revolvingDoor.setInitializationMethod(treeDAG::SeparatorCache::INIT_RevolvingDoor);
+            revolvingDoor.initialize();
+
+            BOOST_CHECK(separatorSet(bruteForce) == separatorSet(revolvingDoor));
+            BOOST_CHECK_EQUAL(bruteForce.statistics().threads[0].candidates, revolvingDoor.statistics().threads[0].candidates);
+        }
+}
+
+void checkStoredSeparations(const Graph & g, std::size_t k)
+{
+    treeDAG::SeparatorCache cache(k, &g);
+    cache.initialize();
+
+    std::size_t fullSize = 0;
+    for(std::pair<treeDAG::SeparatorCache::SeparatorIterator, treeDAG::SeparatorCache::SeparatorIterator> p = cache.separators(); p.first != p.second; ++p.first)
+    {
+        std::vector<std::size_t> separator(p.first->separator().first, p.first->separator().second);
+
+        treeDAG::Separation expected = treeDAG::Separator(&g)(separator.begin(), separator.end());
+        expected.limitToMaximalComponents();
+
+        treeDAG::Separation actual;
+        cache.findSeparator(separator).toSeparation(actual);
+
+        BOOST_CHECK(expected.separator == actual.separator);
+        BOOST_CHECK(expected.componentMap == actual.componentMap);
+        BOOST_CHECK(expected.components == actual.components);
+
+        fullSize += expected.componentMap.size() * sizeof(std::size_t);
+        for(std::size_t i = 0; i < expected.components.size(); ++i)
+            fullSize += expected.components[i].size() * sizeof(std::size_t);
+    }
+
+    BOOST_CHECK_LT(cache.memoryUsage(), fullSize);
+}
+
+BOOST_AUTO_TEST_CASE( separation_store_test )
+{
+    checkStoredSeparations(make_grid(4, 5), 3);
+
+    // a star has more components than fit in a byte label
+    Graph star(400);
+    for(std::size_t i = 1; i < 400; ++i)
+        boost::add_edge(0, i, star);
+    checkStoredSeparations(star, 1);
+}
+
+BOOST_AUTO_TEST_CASE( frozen_store_test )
+{
+    // too many pairs for a rank table, so these are found by binary search
+    Graph g = make_cycle(400);
+    treeDAG::Separator separate(&g);
+    treeDAG::SeparationStore store;
+
+    std::vector<std::size_t> separator(2);
+    for(std::size_t v = 0; v < 400; v += 3)
+    {
+        separator[0] = v;
+        separator[1] = (v * 7 + 2) % 400;
+        std::sort(separator.begin(), separator.end());
+
+        treeDAG::Separation separation = separate(separator.begin(), separator.end());
+        separation.limitToMaximalComponents();
+        store.insert(separation);
+    }
+
+    // and the single vertices are in a rank table
+    std::vector<std::size_t> vertex(1, 17);
+    treeDAG::Separation single = separate(vertex.begin(), vertex.end());
+    store.insert(single);
+
+    treeDAG::SeparationStore hashed = store;
+    store.freeze();
+    BOOST_REQUIRE(store.frozen());
+
+    for(separator[0] = 0; separator[0] < 400; ++separator[0])
+    {
+        vertex.assign(1, separator[0]);
+        BOOST_CHECK(!store.find(vertex) == !hashed.find(vertex));
+
+        for(separator[1] = separator[0] + 1; separator[1] < 400; separator[1] += 5)
+        {
+            treeDAG::SeparationView expected = hashed.find(separator);
+            treeDAG::SeparationView actual = store.find(separator);
+
+            BOOST_REQUIRE(!expected == !actual);
+            if(expected)
+                for(std::size_t v = 0; v < 400; v += 13)
+                    BOOST_CHECK_EQUAL(expected.componentOf(v), actual.componentOf(v));
+        }
+    }
+
+    // inserting thaws the store
+    vertex.assign(1, 18);
+    treeDAG::Separation other = separate(vertex.begin(), vertex.end());
+    BOOST_CHECK(store.insert(other));
+    BOOST_CHECK(!store.frozen());
+    BOOST_CHECK(store.find(vertex) != 0);
+    BOOST_CHECK(store.find(std::vector<std::size_t>(1, 17)) != 0);
+}
+
+BOOST_AUTO_TEST_CASE( lazy_cache_test )
+{
+    typedef treeDAG::util::NChooseKIterator<std::vector<std::size_t>::iterator> CombIter;
+
+    Graph g = make_grid(3, 4);
+    std::vector<std::size_t> vertices;
+    for(std::size_t i = 0; i < 12; ++i)
+        vertices.push_back(i);
+
+    treeDAG::SeparatorCache eager(3, &g);
+    eager.initialize();
+
+    treeDAG::SeparatorCache lazy(3, &g);
+    lazy.setInitializationMethod(treeDAG::SeparatorCache::INIT_Lazy);
+    lazy.initialize();
+    BOOST_CHECK(lazy.separators().first == lazy.separators().second);
+
+    // query everything twice, the second time from the memo
+    for(std::size_t round = 0; round < 2; ++round)
+        for(std::size_t k = 1; k <= 4; ++k)
+            for(std::pair<CombIter, CombIter> p = treeDAG::util::make_n_choose_k_iterators(vertices.begin(), vertices.end(), k); p.first != p.second; ++p.first)
+            {
+                std::vector<std::size_t> separator(p.first->begin(), p.first->end());
+                treeDAG::SeparationView expected = eager.findSeparator(separator);
+                treeDAG::SeparationView actual = lazy.findSeparator(separator);
+
+                BOOST_REQUIRE(!expected == !actual);
+                if(expected)
+                    for(std::size_t v = 0; v < 12; ++v)
+                        BOOST_CHECK_EQUAL(expected.componentOf(v), actual.componentOf(v));
+            }
+
+    BOOST_CHECK(separatorSet(eager) == separatorSet(lazy));
+}
+
+namespace {
+
+void queryAll(const treeDAG::SeparatorCache & cache, const std::vector<std::size_t> & vertices, std::size_t maxK, std::size_t & found)
+{
+    typedef treeDAG::util::NChooseKIterator<std::vector<std::size_t>::const_iterator> CombIter;
+
+    found = 0;
+    for(std::size_t k = 1; k <= maxK; ++k)
+        for(std::pair<CombIter, CombIter> p = treeDAG::util::make_n_choose_k_iterators(vertices.begin(), vertices.end(), k); p.first != p.second; ++p.first)
+        {
+            std::vector<std::size_t> separator(p.first->begin(), p.first->end());
+            std::sort(separator.begin(), separator.end());
+            if(cache.findSeparator(separator))
+                ++found;
+        }
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE( concurrent_lazy_cache_test )
+{
+    Graph g = make_grid(4, 5);
+    std::vector<std::size_t> vertices;
+    for(std::size_t i = 0; i < 20; ++i)
+        vertices.push_back(i);
+
+    treeDAG::SeparatorCache eager(3, &g);
+    eager.initialize();
+
+    treeDAG::SeparatorCache lazy(3, &g);
+    lazy.setInitializationMethod(treeDAG::SeparatorCache::INIT_Lazy);
+    lazy.initialize();
+
+    // all threads query the same separators at the same time, half of them in reverse order
+    const std::size_t numberOfThreads = 8;
+    std::vector<std::vector<std::size_t> > orders(numberOfThreads, vertices);
+    std::vector<std::size_t> found(numberOfThreads);
+
+    boost::thread_group threads;
+    for(std::size_t i = 0; i < numberOfThreads; ++i)
+    {
+        if(i % 2 == 1)
+            std::reverse(orders[i].begin(), orders[i].end());
+        threads.create_thread(boost::bind(&queryAll, boost::cref(lazy), boost::cref(orders[i]), 3, boost::ref(found[i])));
+    }
+    threads.join_all();
+
+    const std::size_t expected = eager.separators().second - eager.separators().first;
+    for(std::size_t i = 0; i < numberOfThreads; ++i)
+        BOOST_CHECK_EQUAL(found[i], expected);
+
+    BOOST_CHECK(separatorSet(eager) == separatorSet(lazy));
+}
+
+BOOST_AUTO_TEST_CASE( containment_index_test )
+{
+    typedef treeDAG::util::NChooseKIterator<std::vector<std::size_t>::iterator> CombIter;
+
+    Graph g = make_grid(3, 5);
+    std::vector<std::size_t> vertices;
+    for(std::size_t i = 0; i < 15; ++i)
+        vertices.push_back(i);
+
+    treeDAG::SeparatorCache eager(3, &g);
+    eager.initialize();
+
+    treeDAG::SeparatorCache lazy(3, &g);
+    lazy.setInitializationMethod(treeDAG::SeparatorCache::INIT_Lazy);
+    lazy.initialize();
+
+    // every stored separator inside the set, from the index and from the lazy lookups
+    for(std::size_t k = 1; k <= 5; ++k)
+        for(std::pair<CombIter, CombIter> p = treeDAG::util::make_n_choose_k_iterators(vertices.begin(), vertices.end(), k); p.first != p.second; ++p.first)
+        {
+            std::vector<std::size_t> set(p.first->begin(), p.first->end());
+
+            std::set<std::vector<std::size_t> > expected;
+            for(std::pair<treeDAG::SeparatorCache::SeparatorIterator, treeDAG::SeparatorCache::SeparatorIterator> s = eager.separators(); s.first != s.second; ++s.first)
+                if(std::includes(set.begin(), set.end(), s.first->separator().first, s.first->separator().second))
+                    expected.insert(std::vector<std::size_t>(s.first->separator().first, s.first->separator().second));
+
+            std::vector<treeDAG::SeparationView> found;
+            eager.findContainedSeparators(set, found);
+            BOOST_CHECK_EQUAL(found.size(), expected.size());
+
+            lazy.findContainedSeparators(set, found);
+            BOOST_REQUIRE_EQUAL(found.size(), 2 * expected.size());
+
+            for(std::size_t i = 0; i < found.size(); ++i)
+                BOOST_CHECK(expected.count(std::vector<std::size_t>(found[i].separator().first, found[i].separator().second)) == 1);
+        }
+}
+
+BOOST_AUTO_TEST_CASE( lookup_statistics_test )
+{
+    typedef treeDAG::util::NChooseKIterator<std::vector<std::size_t>::iterator> CombIter;
+
+    Graph g = make_grid(4, 6);
+    std::vector<std::size_t> vertices;
+    for(std::size_t i = 0; i < 24; ++i)
+        vertices.push_back(i);
+
+    treeDAG::SeparatorCache plain(3, &g);
+    plain.initialize();
+
+    treeDAG::SeparatorCache counted(3, &g);
+    counted.setCountLookups(true);
+    counted.initialize();
+
+    std::size_t lookups = 0;
+    for(std::size_t k = 1; k <= 4; ++k)
+        for(std::pair<CombIter, CombIter> p = treeDAG::util::make_n_choose_k_iterators(vertices.begin(), vertices.end(), k); p.first != p.second; ++p.first, ++lookups)
+        {
+            std::vector<std::size_t> separator(p.first->begin(), p.first->end());
+            BOOST_CHECK(!plain.findSeparator(separator) == !counted.findSeparator(separator));
+        }
+
+    // the hits are exactly the separators, the rest are misses of the presence bitmaps
+    treeDAG::SeparatorCache::LookupStatistics statistics = counted.lookupStatistics();
+    BOOST_CHECK_EQUAL(statistics.lookups, lookups);
+    BOOST_CHECK_EQUAL(statistics.hits, std::size_t(counted.separators().second - counted.separators().first));
+    BOOST_CHECK_EQUAL(statistics.misses(), lookups - statistics.hits);
+    BOOST_CHECK_EQUAL(plain.lookupStatistics().lookups, 0u);
+
+    counted.resetLookupStatistics();
+    BOOST_CHECK_EQUAL(counted.lookupStatistics().lookups, 0u);
+}
+
+BOOST_AUTO_TEST_CASE( lazy_subset_order_test )
+{
+    typedef treeDAG::util::CombinationIterator<std::vector<std::size_t>::const_iterator> CombIter;
+
+    Graph g = make_grid(3, 5);
+    treeDAG::SeparatorCache lazy(3, &g);
+    lazy.setInitializationMethod(treeDAG::SeparatorCache::INIT_Lazy);
+    lazy.initialize();
+
+    // the word masks give the separators in the order of the combination iterator
+    const std::size_t vertices[] = { 0, 1, 3, 4, 5, 7, 8, 10, 11, 13 };
+    const std::vector<std::size_t> set(vertices, vertices + 10);
+
+    std::vector<std::vector<std::size_t> > expected;
+    for(CombIter it = CombIter(set.begin(), set.end()); it != CombIter(); ++it)
+    {
+        std::vector<std::size_t> subset(it->begin(), it->end());
+        if(subset.empty() || subset.size() > 3)
+            continue;
+
+        treeDAG::SeparationView separation = lazy.findSeparator(subset);
+        if(separation)
+            expected.push_back(subset);
+    }
+
+    std::vector<treeDAG::SeparationView> found;
+    lazy.findContainedSeparators(set, found);
+
+    BOOST_CHECK_GT(expected.size(), 0u);
+    BOOST_REQUIRE_EQUAL(found.size(), expected.size());
+    for(std::size_t i = 0; i < found.size(); ++i)
+        BOOST_CHECK(std::vector<std::size_t>(found[i].separator().first, found[i].separator().second) == expected[i]);
+}
+
+BOOST_AUTO_TEST_CASE( graph_reducer_test )
+{
+    typedef treeDAG::GraphReducer::Reduction Reduction;
+
+    // a cycle with a path hanging from it reduces completely, the cycle has treewidth two
+    Graph cycle = make_cycle(6);
+    for(std::size_t i = 6; i < 10; ++i)
+        boost::add_edge(i == 6 ? 0 : i - 1, i, cycle);
+
+    treeDAG::CSRGraph csrCycle(cycle);
+    treeDAG::GraphReducer cycleReducer(&csrCycle);
+    cycleReducer.reduce();
+
+    BOOST_CHECK_EQUAL(cycleReducer.reducedGraph().numVertices(), 0u);
+    BOOST_CHECK_EQUAL(cycleReducer.reductions().size(), 10u);
+    BOOST_CHECK_EQUAL(cycleReducer.lowerBound(), 2u);
+
+    // a grid of treewidth four with a fringe, the root stays
+    Graph g = make_grid(4, 4);
+    for(std::size_t i = 16; i < 19; ++i)
+        boost::add_edge(i == 16 ? 0 : i - 1, i, g);
+
+    treeDAG::CSRGraph csr(g);
+    treeDAG::GraphReducer reducer(&csr);
+    const std::size_t root = 5;
+    reducer.reduce(&root, &root + 1);
+
+    const treeDAG::CSRGraph & reduced = reducer.reducedGraph();
+    BOOST_CHECK_LT(reduced.numVertices(), 16u);
+    BOOST_CHECK_LE(reducer.lowerBound(), 4u);
+    BOOST_REQUIRE(reducer.reducedVertex(root) != treeDAG::SeparatorConfig::UnassignedVertex());
+    BOOST_CHECK_EQUAL(reducer.originalVertex(reducer.reducedVertex(root)), root);
+
+    for(std::vector<Reduction>::const_iterator it = reducer.reductions().begin(); it != reducer.reductions().end(); ++it)
+    {
+        BOOST_CHECK(it->vertex != root);
+        BOOST_CHECK(reducer.reducedVertex(it->vertex) == treeDAG::SeparatorConfig::UnassignedVertex());
+        BOOST_CHECK_LE(it->neighbours.size(), std::max<std::size_t>(it->lowerBound, 1));
+    }
+
+    for(std::size_t v = 16; v < 19; ++v)
+        BOOST_CHECK(reducer.reducedVertex(v) == treeDAG::SeparatorConfig::UnassignedVertex());
+
+    // the dag of the reduced graph is renumbered to the input
+    treeDAG::SubgraphNodeData data;
+    data.activeVertices.push_back(reducer.reducedVertex(root));
+    for(std::size_t v = 0; v < reduced.numVertices(); ++v)
+        if(v != reducer.reducedVertex(root))
+            data.otherVertices.push_back(v);
+
+    treeDAG::DecompositionDAG dag;
+    treeDAG::DecompositionDAG::NodeDescriptor node = dag.addSubgraph(data);
+    reducer.renumber(dag);
+
+    BOOST_CHECK_EQUAL(dag.subgraphNodeData(node)->activeVertices.front(), root);
+    for(std::size_t i = 0; i < data.otherVertices.size(); ++i)
+        BOOST_CHECK_EQUAL(dag.subgraphNodeData(node)->otherVertices[i], reducer.originalVertex(data.otherVertices[i]));
+
+    // the reduced graph goes through the decomposer, and the bags of the removed vertices hang below
+    // the later reductions or the cliques of its dag
+    const std::size_t reducedRoot = reducer.reducedVertex(root);
+    treeDAG::Decomposer decomposer(&reduced, 4);
+    decomposer.initialize();
+    decomposer.process(&reducedRoot, &reducedRoot + 1);
+    BOOST_REQUIRE(decomposer.feasible());
+    reducer.renumber(decomposer.decompositionDAG());
+
+    std::vector<std::vector<std::size_t> > bags(reducer.reductions().size());
+    for(std::size_t i = 0; i < bags.size(); ++i)
+        reducer.bag(i, bags[i]);
+
+    std::size_t joinedToDAG = 0;
+    std::vector<treeDAG::DecompositionDAG::NodeDescriptor> parents;
+    for(std::size_t i = 0; i < bags.size(); ++i)
+    {
+        const Reduction & reduction = reducer.reductions()[i];
+        BOOST_CHECK_LE(bags[i].size(), 5u);
+        reducer.parentBags(i, decomposer.decompositionDAG(), parents);
+
+        if(reduction.parent != treeDAG::GraphReducer::NoReduction())
+        {
+            BOOST_CHECK_GT(reduction.parent, i);
+            BOOST_CHECK(std::includes(bags[reduction.parent].begin(), bags[reduction.parent].end(), reduction.neighbours.begin(), reduction.neighbours.end()));
+            BOOST_CHECK(parents.empty());
+        }
+        else
+        {
+            BOOST_CHECK(!parents.empty());
+            for(std::size_t j = 0; j < reduction.neighbours.size(); ++j)
+                BOOST_CHECK(reducer.reducedVertex(reduction.neighbours[j]) != treeDAG::SeparatorConfig::UnassignedVertex());
+            ++joinedToDAG;
+        }
+    }
+    BOOST_CHECK_GT(joinedToDAG, 0u);
+
+    // every edge at a removed vertex is in the bag of the first of its end points removed
+    boost::graph_traits<Graph>::edge_iterator eit, eend;
+    for(boost::tie(eit, eend) = boost::edges(g); eit != eend; ++eit)
+    {
+        std::size_t first = bags.size();
+        for(std::size_t i = 0; i < bags.size() && first == bags.size(); ++i)
+            if(reducer.reductions()[i].vertex == boost::source(*eit, g) || reducer.reductions()[i].vertex == boost::target(*eit, g))
+                first = i;
+
+        if(first != bags.size())
+            BOOST_CHECK(std::binary_search(bags[first].begin(), bags[first].end(), boost::source(*eit, g))
+                && std::binary_search(bags[first].begin(), bags[first].end(), boost::target(*eit, g)));
+    }
+}
+
+BOOST_AUTO_TEST_CASE( atom_decomposer_test )
+{
+    typedef treeDAG::AtomDecomposer::Atom Atom;
+
+    // two cycles sharing vertex 4, and a triangle on the edge {6, 7}
+    Graph g = make_cycle(5);
+    boost::add_edge(4, 5, g);
+    boost::add_edge(5, 6, g);
+    boost::add_edge(6, 7, g);
+    boost::add_edge(7, 4, g);
+    boost::add_edge(6, 8, g);
+    boost::add_edge(7, 8, g);
+
+    treeDAG::CSRGraph csr(g);
+    treeDAG::AtomDecomposer decomposer(&csr, 2);
+    decomposer.setNumberOfThreads(2);
+    const std::size_t root = 0;
+    decomposer.process(&root, &root + 1);
+
+    const std::vector<Atom> & atoms = decomposer.atoms();
+    BOOST_REQUIRE_EQUAL(atoms.size(), 3u);
+
+    std::set<std::set<std::size_t> > expected;
+    const std::size_t atom0[] = { 0, 1, 2, 3, 4 }, atom1[] = { 4, 5, 6, 7 }, atom2[] = { 6, 7, 8 };
+    expected.insert(std::set<std::size_t>(atom0, atom0 + 5));
+    expected.insert(std::set<std::size_t>(atom1, atom1 + 4));
+    expected.insert(std::set<std::size_t>(atom2, atom2 + 3));
+
+    std::set<std::set<std::size_t> > actual;
+    for(std::size_t i = 0; i < atoms.size(); ++i)
+    {
+        actual.insert(std::set<std::size_t>(atoms[i].vertices.begin(), atoms[i].vertices.end()));
+        BOOST_CHECK(std::includes(atoms[i].vertices.begin(), atoms[i].vertices.end(), atoms[i].separator.begin(), atoms[i].separator.end()));
+
+        if(i == decomposer.rootAtom())
+            BOOST_CHECK(atoms[i].parent == treeDAG::AtomDecomposer::NoParent());
+        else
+        {
+            const Atom & parent = atoms[atoms[i].parent];
+            BOOST_CHECK(std::includes(parent.vertices.begin(), parent.vertices.end(), atoms[i].separator.begin(), atoms[i].separator.end()));
+        }
+
+        // the dags use the input numbering, the triangle is a single bag without a dag
+        BOOST_CHECK_EQUAL(atoms[i].decomposer != 0, atoms[i].vertices.size() > 3);
+        if(atoms[i].decomposer)
+            BOOST_CHECK_GT(decomposer.decompositionDAG(i).numberOfNodes(), 0u);
+    }
+
+    BOOST_CHECK(actual == expected);
+    BOOST_CHECK(std::count(atoms[decomposer.rootAtom()].vertices.begin(), atoms[decomposer.rootAtom()].vertices.end(), root) == 1);
+
+    // every atom has a decomposition, and the separators are in bags of the parents
+    BOOST_CHECK(decomposer.status() == treeDAG::Decomposer::STATUS_Complete);
+    BOOST_CHECK(decomposer.feasible());
+    for(std::size_t i = 0; i < atoms.size(); ++i)
+    {
+        std::vector<treeDAG::DecompositionDAG::NodeDescriptor> bags;
+        decomposer.parentBags(i, bags);
+        if(i == decomposer.rootAtom())
+            BOOST_CHECK(bags.empty());
+        else
+            BOOST_CHECK(!bags.empty());
+
+        for(std::size_t j = 0; j < bags.size(); ++j)
+        {
+            const std::vector<std::size_t> & bag = *decomposer.decompositionDAG(atoms[i].parent).cliqueNodeData(bags[j]);
+            BOOST_CHECK(std::includes(bag.begin(), bag.end(), atoms[i].separator.begin(), atoms[i].separator.end()));
+        }
+    }
+
+    treeDAG::AtomDecomposer infeasible(&csr, 1);
+    infeasible.process(&root, &root + 1);
+    BOOST_CHECK_EQUAL(infeasible.atoms().size(), 3u);
+    BOOST_CHECK(!infeasible.feasible());
+
+    // a cycle has no clique separator
+    Graph cycle = make_cycle(6);
+    treeDAG::CSRGraph csrCycle(cycle);
+    treeDAG::AtomDecomposer cycleDecomposer(&csrCycle, 2);
+    cycleDecomposer.process(&root, &root + 1);
+    BOOST_CHECK_EQUAL(cycleDecomposer.atoms().size(), 1u);
+
+    // a pendant vertex and a triangle hanging off a cycle, their atoms are smaller than the
+    // separators searched for k = 4 and are single bags
+    Graph small = make_cycle(6);
+    boost::add_edge(0, 6, small);
+    boost::add_edge(2, 7, small);
+    boost::add_edge(3, 7, small);
+    treeDAG::CSRGraph csrSmall(small);
+
+    treeDAG::AtomDecomposer smallDecomposer(&csrSmall, 4);
+    smallDecomposer.process(&root, &root + 1);
+    BOOST_REQUIRE_EQUAL(smallDecomposer.atoms().size(), 3u);
+    for(std::size_t i = 0; i < smallDecomposer.atoms().size(); ++i)
+        BOOST_CHECK_EQUAL(smallDecomposer.atoms()[i].decomposer != 0, smallDecomposer.atoms()[i].vertices.size() == 6);
+    BOOST_CHECK(smallDecomposer.status() == treeDAG::Decomposer::STATUS_Complete);
+    BOOST_CHECK(smallDecomposer.feasible());
+
+    // and a cache for a k larger than its graph only searches the sizes there are
+    Graph triangle = make_cycle(3);
+    treeDAG::SeparatorCache cache(4, &triangle);
+    cache.setNumberOfThreads(1);
+    cache.initialize();
+    BOOST_CHECK(separatorSet(cache).empty());
+}
+
+namespace {
+
+std::multiset<std::string> nodeDescriptions(const treeDAG::DecompositionDAG & dag)
+{
+    typedef boost::graph_traits<treeDAG::DecompositionDAG::Structure>::vertex_iterator NodeIterator;
+
+    std::multiset<std::string> descriptions;
+    for(std::pair<NodeIterator, NodeIterator> p = boost::vertices(dag.structure()); p.first != p.second; ++p.first)
+    {
+        std::ostringstream stream;
+        stream << dag.nodeWriter(*p.first);
+        if(dag.nodeType(*p.first) == treeDAG::DecompositionDAG::NODE_Separator)
+            for(std::size_t i = 0; i < dag.separatorNodeData(*p.first)->inactiveComponents.size(); ++i)
+                stream << " " << dag.separatorNodeData(*p.first)->inactiveComponents[i];
+
+        descriptions.insert(stream.str());
+    }
+
+    return descriptions;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE( vertex_ordering_test )
+{
+    typedef treeDAG::VertexOrdering Ordering;
+
+    // a path numbered out of order gets bandwidth one from reverse cuthill mckee
+    Graph g(8);
+    const std::size_t path[] = { 3, 6, 0, 7, 2, 5, 1, 4 };
+    for(std::size_t i = 1; i < 8; ++i)
+        boost::add_edge(path[i - 1], path[i], g);
+
+    treeDAG::CSRGraph csr(g);
+    const Ordering::OrderingMethod methods[] = { Ordering::ORDER_ReverseCuthillMcKee, Ordering::ORDER_BreadthFirst, Ordering::ORDER_Degree };
+    for(std::size_t m = 0; m < 3; ++m)
+    {
+        Ordering ordering(&csr, methods[m]);
+        std::set<std::size_t> image;
+        for(std::size_t v = 0; v < 8; ++v)
+        {
+            image.insert(ordering.orderedVertex(v));
+            BOOST_CHECK_EQUAL(ordering.originalVertex(ordering.orderedVertex(v)), v);
+        }
+        BOOST_CHECK_EQUAL(image.size(), 8u);
+        BOOST_CHECK_EQUAL(ordering.orderedGraph().numEdges(), 7u);
+    }
+
+    Ordering rcm(&csr, Ordering::ORDER_ReverseCuthillMcKee);
+    for(std::size_t i = 1; i < 8; ++i)
+        BOOST_CHECK_EQUAL(std::max(rcm.orderedVertex(path[i - 1]), rcm.orderedVertex(path[i])) - std::min(rcm.orderedVertex(path[i - 1]), rcm.orderedVertex(path[i])), 1u);
+
+    // the decomposer gives the same dag on the ordered graph, in the input numbering
+    Graph grid = make_grid(3, 3);
+    treeDAG::CSRGraph csrGrid(grid);
+    const std::size_t root = 0;
+
+    treeDAG::Decomposer plain(&csrGrid, 3);
+    plain.initialize();
+    plain.process(&root, &root + 1);
+
+    treeDAG::Decomposer ordered(&csrGrid, 3, Ordering::ORDER_ReverseCuthillMcKee);
+    ordered.initialize();
+    ordered.process(&root, &root + 1);
+
+    BOOST_CHECK_GT(plain.decompositionDAG().numberOfNodes(), 1u);
+    BOOST_CHECK_EQUAL(plain.decompositionDAG().numberOfBranches(), ordered.decompositionDAG().numberOfBranches());
+    BOOST_CHECK(nodeDescriptions(plain.decompositionDAG()) == nodeDescriptions(ordered.decompositionDAG()));
+}
+
+BOOST_AUTO_TEST_CASE( parallel_decomposer_test )
+{
+    // the dag is built in the same order for any number of threads
+    Graph grid = make_grid(3, 5);
+    treeDAG::CSRGraph csrGrid(grid);
+    const std::size_t root = 5;
+
+    treeDAG::Decomposer sequential(&csrGrid, 3);
+    sequential.initialize();
+    sequential.process(&root, &root + 1);
+
+    treeDAG::Decomposer parallel(&csrGrid, 3);
+    parallel.setNumberOfThreads(4);
+    BOOST_CHECK_EQUAL(parallel.numberOfThreads(), 4u);
+    parallel.initialize();
+    parallel.process(&root, &root + 1);
+
+    // the nodes are created in the same order
+    typedef boost::graph_traits<treeDAG::DecompositionDAG::Structure>::vertex_iterator NodeIterator;
+    const treeDAG::DecompositionDAG & sequentialDAG = sequential.decompositionDAG();
+    const treeDAG::DecompositionDAG & parallelDAG = parallel.decompositionDAG();
+
+    BOOST_CHECK_GT(sequentialDAG.numberOfNodes(), 1u);
+    BOOST_REQUIRE_EQUAL(sequentialDAG.numberOfNodes(), parallelDAG.numberOfNodes());
+    BOOST_CHECK_EQUAL(sequentialDAG.numberOfBranches(), parallelDAG.numberOfBranches());
+
+    std::pair<NodeIterator, NodeIterator> p = boost::vertices(sequentialDAG.structure());
+    std::pair<NodeIterator, NodeIterator> q = boost::vertices(parallelDAG.structure());
+    for(; p.first != p.second; ++p.first, ++q.first)
+    {
+        std::ostringstream sequentialNode, parallelNode;
+        sequentialNode << sequentialDAG.nodeWriter(*p.first);
+        parallelNode << parallelDAG.nodeWriter(*q.first);
+        BOOST_CHECK_EQUAL(sequentialNode.str(), parallelNode.str());
+        BOOST_CHECK_EQUAL(boost::out_degree(*p.first, sequentialDAG.structure()), boost::out_degree(*q.first, parallelDAG.structure()));
+    }
+
+    // the positions of a clique of k + 1 vertices have to fit in a word
+    treeDAG::Decomposer tooLarge(&csrGrid, 64);
+    BOOST_CHECK_THROW(tooLarge.process(&root, &root + 1), std::logic_error);
+}
+
+BOOST_AUTO_TEST_CASE( seeded_cliques_test )
+{
+    // growing the cliques from the stored separators gives the same dag as trying every subset,
+    // which the lazy cache still does. The second graph is a square and a triangle joined by a path
+    Graph grid = make_grid(3, 5);
+    Graph joined(8);
+    const std::size_t edges[][2] = { {0, 1}, {1, 2}, {2, 3}, {3, 0}, {2, 4}, {4, 5}, {5, 6}, {6, 7}, {7, 5} };
+    for(std::size_t i = 0; i < 9; ++i)
+        boost::add_edge(edges[i][0], edges[i][1], joined);
+
+    const Graph * graphs[] = { &grid, &joined };
+    for(std::size_t i = 0; i < 2; ++i)
+    {
+        treeDAG::CSRGraph csr(*graphs[i]);
+        const std::size_t root = 1;
+
+        treeDAG::Decomposer seeded(&csr, 3);
+        seeded.initialize();
+        seeded.process(&root, &root + 1);
+
+        boost::shared_ptr<treeDAG::SeparatorCache> lazy(new treeDAG::SeparatorCache(3, &csr));
+        lazy->setInitializationMethod(treeDAG::SeparatorCache::INIT_Lazy);
+        lazy->initialize();
+        BOOST_CHECK(!lazy->complete());
+
+        treeDAG::Decomposer exhaustive(&csr, 3, lazy);
+        exhaustive.initialize();
+        exhaustive.process(&root, &root + 1);
+
+        BOOST_CHECK_GT(seeded.decompositionDAG().numberOfNodes(), 1u);
+        BOOST_CHECK_EQUAL(seeded.decompositionDAG().numberOfBranches(), exhaustive.decompositionDAG().numberOfBranches());
+        BOOST_CHECK(nodeDescriptions(seeded.decompositionDAG()) == nodeDescriptions(exhaustive.decompositionDAG()));
+    }
+}
+
+BOOST_AUTO_TEST_CASE( clique_order_test )
+{
+    // among the cliques with the same separator nodes the first one in the subset enumeration is kept,
+    // which is the dag the decomposer gave before the cliques were seeded or enumerated with masks
+    Graph g(8);
+    const std::size_t edges[][2] = { {0, 1}, {0, 2}, {2, 3}, {0, 4}, {4, 5}, {0, 6}, {4, 7}, {7, 1}, {2, 6}, {3, 6} };
+    for(std::size_t i = 0; i < 10; ++i)
+        boost::add_edge(edges[i][0], edges[i][1], g);
+
+    // C(0,2,7) and C(0,6,7) have the same separator nodes, C(0,6,7) comes first
+    const char * nodes[] = { "C(0,1,4)", "C(0,1,4)", "C(0,1,7)", "C(0,1,7)", "C(0,2,6)", "C(0,2,6)", "C(0,4,7)",
+        "C(0,4,7)", "C(0,4,7)", "C(0,6,7)", "G(0),*(1, 2, 3, 4, 5, 6, 7)", "G(0),*(1, 4, 5, 7)", "G(0),*(2, 3, 6)",
+        "G(0, 7),*(1)", "G(0, 7),*(4, 5)", "G(1, 4),*(7)", "G(2, 6),*(3)", "G(4),*(5)", "S(0) 0", "S(0) 1", "S(0,7)",
+        "S(0,7) 0", "S(0,7) 1", "S(1,4) 0", "S(2,6) 0", "S(4) 0" };
+    const std::multiset<std::string> expected(nodes, nodes + 26);
+
+    treeDAG::CSRGraph csr(g);
+    const std::size_t root = 0;
+
+    treeDAG::Decomposer seeded(&csr, 2);
+    seeded.setNumberOfThreads(2);
+    seeded.initialize();
+    seeded.process(&root, &root + 1);
+    BOOST_CHECK(nodeDescriptions(seeded.decompositionDAG()) == expected);
+
+    boost::shared_ptr<treeDAG::SeparatorCache> lazy(new treeDAG::SeparatorCache(2, &csr));
+    lazy->setInitializationMethod(treeDAG::SeparatorCache::INIT_Lazy);
+    lazy->initialize();
+
+    treeDAG::Decomposer exhaustive(&csr, 2, lazy);
+    exhaustive.initialize();
+    exhaustive.process(&root, &root + 1);
+    BOOST_CHECK(nodeDescriptions(exhaustive.decompositionDAG()) == expected);
+}
+
+BOOST_AUTO_TEST_CASE( treewidth_bound_test )
+{
+    typedef treeDAG::TreewidthBound Bound;
+
+    Graph cycle = make_cycle(6);
+    Graph grid = make_grid(4, 4);
+    Graph complete(5);
+    for(std::size_t i = 0; i < 5; ++i)
+        for(std::size_t j = i + 1; j < 5; ++j)
+            boost::add_edge(i, j, complete);
+
+    treeDAG::CSRGraph csrCycle(cycle), csrGrid(grid), csrComplete(complete);
+
+    Bound cycleBound(&csrCycle);
+    BOOST_CHECK_EQUAL(cycleBound.bound(), 2u);
+
+    // the contractions find the treewidth of the grid, the degeneracy does not
+    Bound gridBound(&csrGrid);
+    BOOST_CHECK_EQUAL(gridBound.bound(Bound::BOUND_Degeneracy), 2u);
+    BOOST_CHECK_EQUAL(gridBound.bound(Bound::BOUND_MinorMinWidth), 4u);
+    BOOST_CHECK_EQUAL(gridBound.bound(Bound::BOUND_ContractionDegeneracy), 4u);
+    BOOST_CHECK_EQUAL(gridBound.bound(), 4u);
+
+    BOOST_CHECK_EQUAL(Bound(&csrComplete).bound(), 4u);
+
+    // below the bound the decomposer does not initialize the cache or search
+    const std::size_t root = 0;
+    treeDAG::Decomposer infeasible(&csrCycle, 1);
+    infeasible.initialize();
+    BOOST_CHECK(!infeasible.feasible());
+    BOOST_CHECK_EQUAL(infeasible.lowerBound(), 2u);
+    BOOST_CHECK(infeasible.separatorCache().separators().first == infeasible.separatorCache().separators().second);
+    infeasible.process(&root, &root + 1);
+    BOOST_CHECK_EQUAL(infeasible.decompositionDAG().numberOfNodes(), 0u);
+
+    treeDAG::Decomposer feasible(&csrCycle, 2);
+    feasible.initialize();
+    BOOST_CHECK(feasible.feasible());
+    feasible.process(&root, &root + 1);
+    BOOST_CHECK_GT(feasible.decompositionDAG().numberOfNodes(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE( saved_cache_test )
+{
+    const std::string path = "separatorTest.cache";
+    Graph g = make_grid(4, 5);
+
+    treeDAG::SeparatorCache saved(3, &g);
+    saved.initialize();
+    saved.save(path);
+
+    for(std::size_t k = 1; k <= 3; ++k)
+    {
+        treeDAG::SeparatorCache expected(k, &g);
+        expected.initialize();
+
+        // a file for a larger k can be used for a smaller one
+        treeDAG::SeparatorCache loaded(k, &g);
+        loaded.load(path);
+
+        BOOST_CHECK(separatorSet(expected) == separatorSet(loaded));
+        for(std::pair<treeDAG::SeparatorCache::SeparatorIterator, treeDAG::SeparatorCache::SeparatorIterator> p = expected.separators(); p.first != p.second; ++p.first)
+        {
+            std::vector<std::size_t> separator(p.first->separator().first, p.first->separator().second);
+            treeDAG::SeparationView view = loaded.findSeparator(separator);
+
+            BOOST_REQUIRE(view);
+            for(std::size_t v = 0; v < 20; ++v)
+                BOOST_CHECK_EQUAL(p.first->componentOf(v), view.componentOf(v));
+        }
+    }
+
+    // not for a larger k, or for another graph
+    treeDAG::SeparatorCache larger(4, &g);
+    BOOST_CHECK_THROW(larger.load(path), std::logic_error);
+
+    Graph other = make_grid(5, 4);
+    treeDAG::SeparatorCache otherCache(3, &other);
+    BOOST_CHECK_THROW(otherCache.load(path), std::logic_error);
+
+    // a corrupt word anywhere in the file is either rejected, or leaves every lookup inside the file
+    std::vector<char> bytes;
+    {
+        std::ifstream stream(path.c_str(), std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+    }
+
+    const std::string corruptPath = "separatorTest.corrupt.cache";
+    std::size_t rejected = 0;
+    for(std::size_t offset = 0; offset + 4 <= bytes.size(); offset += 4)
+    {
+        std::vector<char> corrupt(bytes);
+        boost::uint32_t word;
+        std::memcpy(&word, &corrupt[offset], 4);
+        word += 0x40000000;
+        std::memcpy(&corrupt[offset], &word, 4);
+        {
+            std::ofstream stream(corruptPath.c_str(), std::ios::binary | std::ios::trunc);
+            stream.write(&corrupt[0], corrupt.size());
+        }
+
+        treeDAG::SeparatorCache loaded(3, &g);
+        try
+        {
+            loaded.load(corruptPath);
+        }
+        catch(const std::logic_error &)
+        {
+            ++rejected;
+            continue;
+        }
+
+        for(std::pair<treeDAG::SeparatorCache::SeparatorIterator, treeDAG::SeparatorCache::SeparatorIterator> p = saved.separators(); p.first != p.second; ++p.first)
+        {
+            treeDAG::SeparationView view = loaded.findSeparator(std::vector<std::size_t>(p.first->separator().first, p.first->separator().second));
+            if(view)
+                for(std::size_t v = 0; v < 20; ++v)
+                    view.componentOf(v);
+        }
+    }
+    BOOST_CHECK_GT(rejected, 0u);
+
+    std::remove(corruptPath.c_str());
+    std::remove(path.c_str());
+}
+
+BOOST_AUTO_TEST_CASE( increase_k_test )
+{
+    Graph g = make_grid(3, 4);
+
+    // raising k only searches the new sizes, for every method
+    const treeDAG::SeparatorCache::InitializationMethod methods[] = { treeDAG::SeparatorCache::INIT_BruteForce,
+        treeDAG::SeparatorCache::INIT_MinimalSeparatorGeneration, treeDAG::SeparatorCache::INIT_RevolvingDoor };
+    for(std::size_t i = 0; i < 3; ++i)
+    {
+        treeDAG::SeparatorCache fresh(3, &g);
+        fresh.setInitializationMethod(methods[i]);
+        fresh.initialize();
+
+        treeDAG::SeparatorCache raised(1, &g);
+        raised.setInitializationMethod(methods[i]);
+        raised.initialize();
+        raised.increaseK(2);
+        raised.increaseK(3);
+
+        BOOST_CHECK(separatorSet(fresh) == separatorSet(raised));
+        BOOST_CHECK_THROW(raised.increaseK(2), std::logic_error);
+    }
+
+    // a hashed store is raised in the same way, as for the sizes which cannot be ranked in 64 bits
+    treeDAG::SeparatorCache fresh(3, &g);
+    fresh.initialize();
+
+    treeDAG::SeparatorCache hashed(1, &g);
+    hashed.setRankIndex(false);
+    hashed.initialize();
+    BOOST_CHECK(hashed.complete());
+    hashed.increaseK(3);
+    BOOST_CHECK(separatorSet(fresh) == separatorSet(hashed));
+
+    const std::size_t square[] = { 0, 1, 3, 4 };
+    std::vector<treeDAG::SeparationView> expected, actual;
+    fresh.findContainedSeparators(std::vector<std::size_t>(square, square + 4), expected);
+    hashed.findContainedSeparators(std::vector<std::size_t>(square, square + 4), actual);
+    BOOST_CHECK_EQUAL(expected.size(), actual.size());
+
+    // the lazy cache answers the larger queries
+    treeDAG::SeparatorCache lazy(2, &g);
+    lazy.setInitializationMethod(treeDAG::SeparatorCache::INIT_Lazy);
+    lazy.initialize();
+    const std::size_t row[] = { 3, 4, 5 };
+    BOOST_CHECK(!lazy.findSeparator(std::vector<std::size_t>(row, row + 3)));
+    lazy.increaseK(3);
+    BOOST_CHECK(lazy.findSeparator(std::vector<std::size_t>(row, row + 3)));
+
+    // a shared cache should be for the same graph and at least k, also after raising k
+    treeDAG::CSRGraph csr(g);
+    treeDAG::CSRGraph sameCsr(g);
+    treeDAG::CSRGraph cycle(make_cycle(12));
+    boost::shared_ptr<treeDAG::SeparatorCache> shared(new treeDAG::SeparatorCache(2, &csr));
+    shared->initialize();
+    BOOST_CHECK_EQUAL(shared->k(), 2u);
+    BOOST_CHECK(shared->graph() == &csr);
+
+    BOOST_CHECK_THROW(treeDAG::Decomposer(&csr, 3, shared), std::logic_error);
+    BOOST_CHECK_THROW(treeDAG::Decomposer(&cycle, 2, shared), std::logic_error);
+
+    treeDAG::Decomposer sharing(&sameCsr, 2, shared);
+    sharing.initialize();
+    const std::size_t root = 0;
+    sharing.process(&root, &root + 1);
+    sharing.increaseK(3);
+    BOOST_CHECK_THROW(sharing.process(&root, &root + 1), std::logic_error);
+    shared->increaseK(3);
+    sharing.process(&root, &root + 1);
+    BOOST_CHECK(sharing.status() == treeDAG::Decomposer::STATUS_Complete);
+}
+
+BOOST_AUTO_TEST_CASE( incremental_decomposer_test )
+{
+    // continuing with a larger k gives the same dag as starting over, also from an infeasible k
+    Graph grid = make_grid(3, 5);
+    Graph cycle = make_cycle(6);
+    treeDAG::CSRGraph csrGrid(grid), csrCycle(cycle);
+    const treeDAG::CSRGraph * graphs[] = { &csrGrid, &csrGrid, &csrCycle };
+    const std::size_t firstK[] = { 2, 3, 2 };
+    const std::size_t root = 0;
+
+    for(std::size_t i = 0; i < 3; ++i)
+    {
+        treeDAG::Decomposer fresh(graphs[i], firstK[i] + 1);
+        fresh.initialize();
+        fresh.process(&root, &root + 1);
+
+        treeDAG::Decomposer incremental(graphs[i], firstK[i]);
+        incremental.setIncremental(true);
+        incremental.setNumberOfThreads(4);
+        incremental.initialize();
+        incremental.process(&root, &root + 1);
+        incremental.increaseK(firstK[i] + 1);
+        BOOST_CHECK_EQUAL(incremental.k(), firstK[i] + 1);
+        incremental.process(&root, &root + 1);
+
+        BOOST_CHECK_GT(fresh.decompositionDAG().numberOfNodes(), 1u);
+        BOOST_CHECK_EQUAL(fresh.decompositionDAG().numberOfBranches(), incremental.decompositionDAG().numberOfBranches());
+        BOOST_CHECK(nodeDescriptions(fresh.decompositionDAG()) == nodeDescriptions(incremental.decompositionDAG()));
+        BOOST_CHECK_THROW(incremental.increaseK(firstK[i]), std::logic_error);
+    }
+
+    // the sweep starts at the lower bound and stops at the treewidth
+    treeDAG::IterativeDecomposer iterative(&csrGrid, 5);
+    BOOST_CHECK(iterative.process(&root, &root + 1));
+    BOOST_CHECK_EQUAL(iterative.k(), 3u);
+    BOOST_REQUIRE(!iterative.iterations().empty());
+    BOOST_CHECK_EQUAL(iterative.iterations().front().k, treeDAG::TreewidthBound(&csrGrid).bound());
+    BOOST_CHECK_EQUAL(iterative.iterations().back().numberOfNodes, iterative.decompositionDAG().numberOfNodes());
+}
+
+namespace {
+
+void cancelOnProgress(treeDAG::CancellationToken token, std::size_t & calls, const treeDAG::Decomposer::Progress &)
+{
+    ++calls;
+    token.cancel();
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE( decomposer_budget_test )
+{
+    typedef treeDAG::Decomposer Decomposer;
+
+    Graph grid = make_grid(3, 5);
+    treeDAG::CSRGraph csrGrid(grid);
+    const std::size_t root = 0;
+
+    Decomposer complete(&csrGrid, 3);
+    complete.initialize();
+    complete.process(&root, &root + 1);
+    BOOST_CHECK_EQUAL(complete.status(), Decomposer::STATUS_Complete);
+    BOOST_CHECK_GT(complete.progress().separatorHits, 0u);
+    BOOST_CHECK_EQUAL(complete.progress().queueDepth, 0u);
+
+    // every budget stops after the first batch, and leaves a part of the dag
+    Decomposer::Budget budgets[3];
+    budgets[0].time = boost::chrono::nanoseconds(1);
+    budgets[1].nodes = 1;
+    budgets[2].bytes = 1;
+    const Decomposer::Status expected[] = { Decomposer::STATUS_TimeBudget, Decomposer::STATUS_NodeBudget, Decomposer::STATUS_MemoryBudget };
+
+    for(std::size_t i = 0; i < 3; ++i)
+    {
+        Decomposer bounded(&csrGrid, 3);
+        bounded.setBudget(budgets[i]);
+        bounded.initialize();
+        bounded.process(&root, &root + 1);
+
+        BOOST_CHECK_EQUAL(bounded.status(), expected[i]);
+        BOOST_CHECK_GE(bounded.decompositionDAG().numberOfNodes(), 1u);
+        BOOST_CHECK_LT(bounded.decompositionDAG().numberOfNodes(), complete.decompositionDAG().numberOfNodes());
+
+        // the next run starts over
+        bounded.setBudget(Decomposer::Budget());
+        bounded.process(&root, &root + 1);
+        BOOST_CHECK_EQUAL(bounded.status(), Decomposer::STATUS_Complete);
+        BOOST_CHECK(nodeDescriptions(bounded.decompositionDAG()) == nodeDescriptions(complete.decompositionDAG()));
+    }
+
+    // also after a complete run
+    const std::multiset<std::string> completeNodes = nodeDescriptions(complete.decompositionDAG());
+    complete.process(&root, &root + 1);
+    BOOST_CHECK_EQUAL(complete.status(), Decomposer::STATUS_Complete);
+    BOOST_CHECK(nodeDescriptions(complete.decompositionDAG()) == completeNodes);
+
+    // cancelled from the progress callback after the root, so the next batch skips its nodes. The
+    // incremental mode then starts over
+    Decomposer cancelled(&csrGrid, 3);
+    cancelled.setIncremental(true);
+    treeDAG::CancellationToken token = cancelled.cancellationToken();
+    std::size_t calls = 0;
+    cancelled.setProgressCallback(boost::bind(&cancelOnProgress, token, boost::ref(calls), _1));
+    cancelled.initialize();
+    cancelled.process(&root, &root + 1);
+
+    BOOST_CHECK_EQUAL(cancelled.status(), Decomposer::STATUS_Cancelled);
+    BOOST_CHECK_EQUAL(calls, 2u);
+    BOOST_CHECK_LT(cancelled.decompositionDAG().numberOfNodes(), complete.decompositionDAG().numberOfNodes());
+
+    token.reset();
+    cancelled.setProgressCallback(Decomposer::ProgressCallback());
+    cancelled.process(&root, &root + 1);
+    BOOST_CHECK_EQUAL(cancelled.status(), Decomposer::STATUS_Complete);
+    BOOST_CHECK(nodeDescriptions(cancelled.decompositionDAG()) == nodeDescriptions(complete.decompositionDAG()));
+}
@@ -17,3 +17,19 @@ treeDAG::SeparatorConfig::Graph make_cycle(std::size_t size)
 
     return g;
 }
+
+treeDAG::SeparatorConfig::Graph make_grid(std::size_t width, std::size_t height)
+{
+    treeDAG::SeparatorConfig::Graph g(width * height);
+
+    for(std::size_t y = 0; y < height; ++y)
+        for(std::size_t x = 0; x < width; ++x)
+        {
+            if(x + 1 < width)
+                boost::add_edge(y * width + x, y * width + x + 1, g);
+            if(y + 1 < height)
+                boost::add_edge(y * width + x, (y + 1) * width + x, g);
+        }
+
+    return g;
+}
@@ -5,5 +5,6 @@
 
 treeDAG::SeparatorConfig::Graph make_path(std::size_t size);
 treeDAG::SeparatorConfig::Graph make_cycle(std::size_t size);
+treeDAG::SeparatorConfig::Graph make_grid(std::size_t width, std::size_t height);
 
 #endif // TREEDAG_TEST_UTIL_HPP
@@ -0,0 +1,377 @@
+#include "atomDecomposer.hpp"
+#include <boost/thread.hpp>
+#include <boost/bind.hpp>
+#include <algorithm>
+#include <deque>
+
+namespace treeDAG {
+
+
+AtomDecomposer::AtomDecomposer(const CSRGraph * graph, std::size_t k)
+    : graph_(graph),
+      k_(k),
+      numberOfThreads_(1),
+      rootAtom_(0)
+{
+}
+
+
+void AtomDecomposer::setNumberOfThreads(std::size_t numberOfThreads)
+{
+    numberOfThreads_ = numberOfThreads;
+}
+
+
+std::size_t AtomDecomposer::numberOfThreads() const
+{
+    return numberOfThreads_;
+}
+
+
+void AtomDecomposer::process(const VertexSet & roots)
+{
+    std::vector<VertexSet> atoms;
+    std::vector<VertexSet> separators;
+    findAtoms(atoms, separators);
+    buildTree(atoms, separators, roots);
+
+    // the atoms are independent
+    std::size_t numberOfThreads = numberOfThreads_ == 0 ? boost::thread::hardware_concurrency() : numberOfThreads_;
+    numberOfThreads = std::max<std::size_t>(1, std::min(numberOfThreads, atoms_.size()));
+
+    boost::atomic<std::size_t> next(0);
+    if(numberOfThreads == 1)
+    {
+        decomposeWorker(next);
+        return;
+    }
+
+    boost::thread_group threads;
+    for(std::size_t i = 0; i < numberOfThreads; ++i)
+        threads.create_thread(boost::bind(&AtomDecomposer::decomposeWorker, this, boost::ref(next)));
+    threads.join_all();
+}
+
+
+Decomposer::Status AtomDecomposer::status() const
+{
+    for(std::vector<Atom>::const_iterator it = atoms_.begin(); it != atoms_.end(); ++it)
+        if(it->decomposer && it->decomposer->status() != Decomposer::STATUS_Complete)
+            return it->decomposer->status();
+
+    return Decomposer::STATUS_Complete;
+}
+
+
+bool AtomDecomposer::feasible() const
+{
+    if(atoms_.empty() || status() != Decomposer::STATUS_Complete)
+        return false;
+
+    for(std::size_t atom = 0; atom < atoms_.size(); ++atom)
+        if(!feasible(atom))
+            return false;
+
+    return true;
+}
+
+
+bool AtomDecomposer::feasible(std::size_t atom) const
+{
+    const Atom & a = atoms_[atom];
+    if(a.vertices.size() <= k_ + 1)
+        return true;
+
+    // a cleaned dag without a decomposition only keeps its root
+    return a.decomposer->feasible() && a.decomposer->decompositionDAG().numberOfNodes() > 1;
+}
+
+
+void AtomDecomposer::parentBags(std::size_t atom, std::vector<DecompositionDAG::NodeDescriptor> & bags) const
+{
+    typedef boost::graph_traits<DecompositionDAG::Structure>::vertex_iterator NodeIterator;
+
+    bags.clear();
+    if(atoms_[atom].parent == NoParent() || !atoms_[atoms_[atom].parent].decomposer)
+        return;
+
+    const VertexSet & separator = atoms_[atom].separator;
+    const DecompositionDAG & dag = decompositionDAG(atoms_[atom].parent);
+    for(std::pair<NodeIterator, NodeIterator> p = boost::vertices(dag.structure()); p.first != p.second; ++p.first)
+    {
+        if(dag.nodeType(*p.first) != DecompositionDAG::NODE_Clique)
+            continue;
+
+        const VertexSet & clique = *dag.cliqueNodeData(*p.first);
+        if(std::includes(clique.begin(), clique.end(), separator.begin(), separator.end()))
+            bags.push_back(*p.first);
+    }
+}
+
+
+void AtomDecomposer::findAtoms(std::vector<VertexSet> & atoms, std::vector<VertexSet> & separators) const
+{
+    typedef CSRGraph::AdjacencyIterator adjIt;
+
+    const std::size_t graphSize = graph_->numVertices();
+
+    VertexSet order;
+    std::vector<VertexSet> madj;
+    std::vector<bool> generators;
+    minimalTriangulation(order, madj, generators);
+
+    // in elimination order, the higher neighbours of a generator are a minimal separator of the
+    // triangulation. When they are a clique of the graph, the component of the vertex and the
+    // separator are an atom, and the component is removed
+    std::vector<bool> removed(graphSize, false);
+    std::vector<bool> blocked(graphSize, false);
+    std::size_t remaining = graphSize;
+
+    for(VertexSet::const_reverse_iterator it = order.rbegin(); it != order.rend(); ++it)
+    {
+        const VertexIndexType x = *it;
+        if(!generators[x] || removed[x] || !isClique(madj[x]))
+            continue;
+
+        const VertexSet & separator = madj[x];
+        for(VertexSet::const_iterator jt = separator.begin(); jt != separator.end(); ++jt)
+            blocked[*jt] = true;
+
+        VertexSet component(1, x);
+        blocked[x] = true;
+        for(std::size_t i = 0; i < component.size(); ++i)
+            for(std::pair<adjIt, adjIt> p = graph_->adjacentVertices(component[i]); p.first != p.second; ++p.first)
+                if(!removed[*p.first] && !blocked[*p.first])
+                {
+                    blocked[*p.first] = true;
+                    component.push_back(*p.first);
+                }
+
+        for(VertexSet::const_iterator jt = separator.begin(); jt != separator.end(); ++jt)
+            blocked[*jt] = false;
+        for(VertexSet::const_iterator jt = component.begin(); jt != component.end(); ++jt)
+            blocked[*jt] = false;
+
+        // the separator should leave something on the other side
+        if(component.size() + separator.size() == remaining)
+            continue;
+
+        for(VertexSet::const_iterator jt = component.begin(); jt != component.end(); ++jt)
+            removed[*jt] = true;
+        remaining -= component.size();
+
+        component.insert(component.end(), separator.begin(), separator.end());
+        std::sort(component.begin(), component.end());
+        atoms.push_back(component);
+        separators.push_back(separator);
+    }
+
+    // and what is left is the last atom
+    VertexSet last;
+    for(VertexIndexType v = 0; v < graphSize; ++v)
+        if(!removed[v])
+            last.push_back(v);
+
+    atoms.push_back(last);
+    separators.push_back(VertexSet());
+}
+
+
+void AtomDecomposer::minimalTriangulation(VertexSet & order, std::vector<VertexSet> & madj, std::vector<bool> & generators) const
+{
+    typedef CSRGraph::AdjacencyIterator adjIt;
+
+    // MCS-M: the vertex of the highest weight is numbered next, and every unnumbered vertex reachable
+    // over unnumbered vertices of a lower weight gets a fill edge to it. Such a path is found with a
+    // bucket search on the largest weight along the path
+    const std::size_t graphSize = graph_->numVertices();
+    const std::size_t Unreached = std::numeric_limits<std::size_t>::max();
+
+    std::vector<std::size_t> weight(graphSize, 0);
+    std::vector<bool> numbered(graphSize, false);
+    std::vector<std::size_t> reach(graphSize);
+    std::vector<bool> expanded(graphSize);
+    std::vector<VertexSet> buckets(graphSize + 1);
+    VertexSet reached;
+
+    order.clear();
+    madj.assign(graphSize, VertexSet());
+    generators.assign(graphSize, false);
+    std::size_t previousWeight = 0;
+
+    for(std::size_t i = 0; i < graphSize; ++i)
+    {
+        VertexIndexType v = UnassignedVertex();
+        for(VertexIndexType u = 0; u < graphSize; ++u)
+            if(!numbered[u] && (v == UnassignedVertex() || weight[u] > weight[v]))
+                v = u;
+
+        // a weight which does not grow starts a new clique of the triangulation
+        if(i != 0 && weight[v] <= previousWeight)
+            generators[v] = true;
+        previousWeight = weight[v];
+
+        numbered[v] = true;
+        order.push_back(v);
+
+        // the reach of a vertex is the largest weight strictly inside the best path from v, the
+        // neighbours have nothing inside, which is stored as zero with the weights shifted by one
+        std::fill(reach.begin(), reach.end(), Unreached);
+        std::fill(expanded.begin(), expanded.end(), false);
+        reached.clear();
+        for(std::pair<adjIt, adjIt> p = graph_->adjacentVertices(v); p.first != p.second; ++p.first)
+            if(!numbered[*p.first] && reach[*p.first] == Unreached)
+            {
+                reach[*p.first] = 0;
+                buckets[weight[*p.first] + 1].push_back(*p.first);
+            }
+
+        for(std::size_t b = 0; b < buckets.size(); ++b)
+            for(std::size_t j = 0; j < buckets[b].size(); ++j)
+            {
+                const VertexIndexType u = buckets[b][j];
+                const std::size_t through = std::max(reach[u], weight[u] + 1);
+                if(expanded[u] || through != b)
+                    continue;
+
+                expanded[u] = true;
+                reached.push_back(u);
+                for(std::pair<adjIt, adjIt> p = graph_->adjacentVertices(u); p.first != p.second; ++p.first)
+                    if(!numbered[*p.first] && through < reach[*p.first])
+                    {
+                        reach[*p.first] = through;
+                        buckets[std::max(through, weight[*p.first] + 1)].push_back(*p.first);
+                    }
+            }
+
+        for(std::size_t b = 0; b < buckets.size(); ++b)
+            buckets[b].clear();
+
+        // the vertices with a path of lower weights get the fill edge
+        for(VertexSet::const_iterator it = reached.begin(); it != reached.end(); ++it)
+            if(reach[*it] < weight[*it] + 1)
+                madj[*it].push_back(v);
+
+        for(VertexSet::const_iterator it = reached.begin(); it != reached.end(); ++it)
+            if(reach[*it] < weight[*it] + 1)
+                ++weight[*it];
+    }
+
+    for(VertexIndexType v = 0; v < graphSize; ++v)
+        std::sort(madj[v].begin(), madj[v].end());
+}
+
+
+void AtomDecomposer::buildTree(const std::vector<VertexSet> & atoms, const std::vector<VertexSet> & separators, const VertexSet & roots)
+{
+    atoms_.clear();
+
+    // the atom of the roots, otherwise the whole graph is one atom
+    std::size_t rootAtom = NoParent();
+    for(std::size_t i = 0; i < atoms.size() && rootAtom == NoParent(); ++i)
+        if(std::includes(atoms[i].begin(), atoms[i].end(), roots.begin(), roots.end()))
+            rootAtom = i;
+
+    if(rootAtom == NoParent())
+    {
+        Atom atom;
+        for(VertexIndexType v = 0; v < graph_->numVertices(); ++v)
+            atom.vertices.push_back(v);
+        atom.separator = roots;
+        atom.parent = NoParent();
+        atoms_.push_back(atom);
+        rootAtom_ = 0;
+    }
+    else
+    {
+        // an atom hangs below the first later atom containing its separator, which is turned
+        // into a tree rooted at the atom of the roots
+        std::vector<std::vector<std::size_t> > neighbours(atoms.size());
+        std::vector<std::vector<std::size_t> > edgeSeparators(atoms.size());
+        for(std::size_t i = 0; i + 1 < atoms.size(); ++i)
+            for(std::size_t j = i + 1; j < atoms.size(); ++j)
+                if(std::includes(atoms[j].begin(), atoms[j].end(), separators[i].begin(), separators[i].end()))
+                {
+                    neighbours[i].push_back(j);
+                    edgeSeparators[i].push_back(i);
+                    neighbours[j].push_back(i);
+                    edgeSeparators[j].push_back(i);
+                    break;
+                }
+
+        atoms_.resize(atoms.size());
+        std::vector<bool> visited(atoms.size(), false);
+        std::deque<std::size_t> queue(1, rootAtom);
+        visited[rootAtom] = true;
+        atoms_[rootAtom].separator = roots;
+        atoms_[rootAtom].parent = NoParent();
+
+        while(!queue.empty())
+        {
+            const std::size_t atom = queue.front();
+            queue.pop_front();
+            atoms_[atom].vertices = atoms[atom];
+
+            for(std::size_t i = 0; i < neighbours[atom].size(); ++i)
+            {
+                const std::size_t child = neighbours[atom][i];
+                if(visited[child])
+                    continue;
+
+                visited[child] = true;
+                atoms_[child].separator = separators[edgeSeparators[atom][i]];
+                atoms_[child].parent = atom;
+                queue.push_back(child);
+            }
+        }
+
+        rootAtom_ = rootAtom;
+    }
+
+    // the graphs induced by the atoms
+    for(std::vector<Atom>::iterator it = atoms_.begin(); it != atoms_.end(); ++it)
+        it->graph.reset(new CSRGraph(graph_->induced(it->vertices)));
+}
+
+
+void AtomDecomposer::decompose(std::size_t atom)
+{
+    Atom & a = atoms_[atom];
+
+    // a single bag holds the atom, and its separators would be larger than the atom
+    if(a.vertices.size() <= k_ + 1)
+        return;
+
+    // the roots in the numbering of the atom
+    VertexSet roots;
+    for(VertexSet::const_iterator it = a.separator.begin(); it != a.separator.end(); ++it)
+        roots.push_back(std::lower_bound(a.vertices.begin(), a.vertices.end(), *it) - a.vertices.begin());
+
+    a.decomposer.reset(new Decomposer(a.graph.get(), k_));
+    a.decomposer->initialize();
+    a.decomposer->process(roots.begin(), roots.end());
+    a.decomposer->decompositionDAG().relabel(a.vertices);
+}
+
+
+void AtomDecomposer::decomposeWorker(boost::atomic<std::size_t> & next)
+{
+    for(std::size_t atom = next++; atom < atoms_.size(); atom = next++)
+        decompose(atom);
+}
+
+
+bool AtomDecomposer::isClique(const VertexSet & vertices) const
+{
+    for(std::size_t i = 0; i < vertices.size(); ++i)
+    {
+        std::pair<CSRGraph::AdjacencyIterator, CSRGraph::AdjacencyIterator> p = graph_->adjacentVertices(vertices[i]);
+        for(std::size_t j = i + 1; j < vertices.size(); ++j)
+            if(!std::binary_search(p.first, p.second, vertices[j]))
+                return false;
+    }
+
+    return true;
+}
+
+} // namespace treeDAG
@@ -0,0 +1,83 @@
+#ifndef TREEDAG_ATOMDECOMPOSER_HPP
+#define TREEDAG_ATOMDECOMPOSER_HPP
+
+#include "decomposer.hpp"
+#include <boost/shared_ptr.hpp>
+#include <boost/atomic.hpp>
+
+namespace treeDAG {
+
+// splits a graph along its clique minimal separators into atoms, and decomposes every atom with
+// a decomposer of its own. The atoms form a tree: every atom shares a clique separator with its
+// parent, and is decomposed with that separator as its roots, the root atom with the roots of
+// the whole graph. A tree decomposition of the graph is a decomposition of every atom, with the
+// root bag of an atom joined to a bag of its parent containing the separator. The atoms follow
+// from a minimal triangulation (MCS-M) with the atoms algorithm of Berry, Pogorelcnik and Simonet
+class AtomDecomposer : public SeparatorConfig
+{
+public:
+    struct Atom
+    {
+        // the vertices in the input numbering, the graph numbers them in this order
+        VertexSet vertices;
+        boost::shared_ptr<const CSRGraph> graph;
+
+        // the separator shared with the parent, the roots for the root atom
+        VertexSet separator;
+        std::size_t parent;
+
+        // none for an atom of at most k + 1 vertices, which is a single bag
+        boost::shared_ptr<Decomposer> decomposer;
+    };
+
+    static std::size_t NoParent() { return std::numeric_limits<std::size_t>::max(); }
+
+    AtomDecomposer(const CSRGraph * graph, std::size_t k);
+
+    // the number of atoms decomposed at the same time, zero for all available cores
+    void setNumberOfThreads(std::size_t numberOfThreads);
+    std::size_t numberOfThreads() const;
+
+    // when the roots are not inside a single atom, the graph is decomposed as one atom
+    template <typename VertexIterator> void process(VertexIterator firstRoot, VertexIterator lastRoot);
+
+    const std::vector<Atom> & atoms() const { return atoms_; }
+    std::size_t rootAtom() const { return rootAtom_; }
+
+    // the dag of an atom of more than k + 1 vertices, in the input numbering
+    const DecompositionDAG & decompositionDAG(std::size_t atom) const { return atoms_[atom].decomposer->decompositionDAG(); }
+
+    // the status of the first atom whose run did not complete, STATUS_Complete when all of them did.
+    // The atoms of at most k + 1 vertices are not decomposed, and always complete
+    Decomposer::Status status() const;
+
+    // whether every atom, and so the graph, has a decomposition of width at most k. An atom of at most
+    // k + 1 vertices is a single bag, a larger one needs cliques below the root of its dag
+    bool feasible() const;
+
+    // the clique nodes in the dag of the parent which contain the separator of the atom, the root bag of
+    // the atom is joined to one of them. A parent of at most k + 1 vertices is a single bag without nodes
+    void parentBags(std::size_t atom, std::vector<DecompositionDAG::NodeDescriptor> & bags) const;
+
+private:
+    void process(const VertexSet & roots);
+    void findAtoms(std::vector<VertexSet> & atoms, std::vector<VertexSet> & separators) const;
+    void minimalTriangulation(VertexSet & order, std::vector<VertexSet> & madj, std::vector<bool> & generators) const;
+    void buildTree(const std::vector<VertexSet> & atoms, const std::vector<VertexSet> & separators, const VertexSet & roots);
+    void decompose(std::size_t atom);
+    void decomposeWorker(boost::atomic<std::size_t> & next);
+    bool feasible(std::size_t atom) const;
+    bool isClique(const VertexSet & vertices) const;
+
+    const CSRGraph * graph_;
+    std::size_t k_;
+    std::size_t numberOfThreads_;
+    std::vector<Atom> atoms_;
+    std::size_t rootAtom_;
+};
+
+} // namespace treeDAG
+
+#include "atomDecomposer.hxx"
+
+#endif // TREEDAG_ATOMDECOMPOSER_HPP
@@ -0,0 +1,17 @@
+#ifndef TREEDAG_ATOMDECOMPOSER_HXX
+#define TREEDAG_ATOMDECOMPOSER_HXX
+
+#include "atomDecomposer.hpp"
+
+namespace treeDAG {
+
+template <typename VertexIterator>
+void AtomDecomposer::process(VertexIterator firstRoot, VertexIterator lastRoot)
+{
+    std::set<VertexIndexType> roots(firstRoot, lastRoot);
+    process(VertexSet(roots.begin(), roots.end()));
+}
+
+} // namespace treeDAG
+
+#endif // TREEDAG_ATOMDECOMPOSER_HXX
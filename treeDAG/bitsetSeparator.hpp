@@ -0,0 +1,60 @@
+#ifndef TREEDAG_BITSETSEPARATOR_HPP
+#define TREEDAG_BITSETSEPARATOR_HPP
+
+#include "separatorConfig.hpp"
+#include "separation.hpp"
+#include "csrGraph.hpp"
+#include "util/bitsetWord.hpp"
+#include <boost/shared_ptr.hpp>
+
+namespace treeDAG {
+
+// a separator which stores the adjacency as rows of fixed width words, and grows the components
+// with word wide frontier operations. Copies share the adjacency but have their own scratch space
+template <typename Word = boost::uint64_t>
+class BitsetSeparator : public SeparatorConfig
+{
+public:
+    typedef SeparatorConfig::Graph                          Graph;
+    typedef Separation                                      result_type;
+    typedef util::BitsetWordTraits<Word>                    Traits;
+
+    BitsetSeparator();
+    explicit BitsetSeparator(const Graph * graph);
+    explicit BitsetSeparator(const CSRGraph * graph);
+
+    template <typename SeparatorVertexIterator> void separate(SeparatorVertexIterator first, SeparatorVertexIterator last, result_type & separation) const;
+    template <typename SeparatorVertexIterator> result_type operator()(SeparatorVertexIterator first, SeparatorVertexIterator last) const;
+    template <typename SeparatorVertexIterator> result_type operator()(const std::pair<SeparatorVertexIterator, SeparatorVertexIterator> & separatorRange) const;
+
+    // whether the vertices are a minimal separator, without building the components
+    template <typename SeparatorVertexIterator> bool isMinimalSeparator(SeparatorVertexIterator first, SeparatorVertexIterator last) const;
+
+private:
+    struct ComponentWriter;
+
+    void initialize(const CSRGraph & graph);
+    void growComponent(VertexIndexType source) const;
+    void fillComponent(const VertexSet & separator, std::size_t componentNumber, result_type & separation) const;
+    void resetRemaining(const VertexSet & separator) const;
+    bool isFullComponent(const VertexSet & separator) const;
+
+    const Word * row(VertexIndexType vertex) const { return &(*adjacency_)[vertex * wordsPerRow_]; }
+
+    std::size_t numberOfVertices_;
+    std::size_t wordsPerRow_;
+    boost::shared_ptr<const std::vector<Word> > adjacency_;
+
+    // scratch space
+    mutable std::vector<Word> remaining_;
+    mutable std::vector<Word> component_;
+    mutable std::vector<Word> frontier_;
+    mutable std::vector<Word> next_;
+    mutable VertexSet separator_;
+};
+
+} // namespace treeDAG
+
+#include "bitsetSeparator.hxx"
+
+#endif // TREEDAG_BITSETSEPARATOR_HPP
@@ -0,0 +1,277 @@
+#ifndef TREEDAG_BITSETSEPARATOR_HXX
+#define TREEDAG_BITSETSEPARATOR_HXX
+
+#include "bitsetSeparator.hpp"
+#include <algorithm>
+
+namespace treeDAG {
+
+#define TDEF template <typename Word>
+#define CDEF BitsetSeparator<Word>
+
+TDEF
+struct CDEF::ComponentWriter
+{
+    ComponentWriter(ComponentMap & componentMap, VertexSet & component, std::size_t componentNumber)
+        : componentMap_(componentMap),
+          component_(component),
+          componentNumber_(componentNumber)
+    {
+    }
+
+    void operator()(VertexIndexType vertex)
+    {
+        if(componentMap_[vertex] != SeparatorVertex())
+            componentMap_[vertex] = componentNumber_;
+
+        component_.push_back(vertex);
+    }
+
+    ComponentMap & componentMap_;
+    VertexSet & component_;
+    std::size_t componentNumber_;
+};
+
+namespace detail {
+
+template <typename Word>
+struct RowAccumulator
+{
+    RowAccumulator(const Word * adjacency, std::size_t wordsPerRow, Word * target)
+        : adjacency_(adjacency),
+          wordsPerRow_(wordsPerRow),
+          target_(target)
+    {
+    }
+
+    void operator()(std::size_t vertex)
+    {
+        const Word * row = adjacency_ + vertex * wordsPerRow_;
+        for(std::size_t w = 0; w < wordsPerRow_; ++w)
+            target_[w] |= row[w];
+    }
+
+    const Word * adjacency_;
+    std::size_t wordsPerRow_;
+    Word * target_;
+};
+
+} // namespace detail
+
+TDEF
+CDEF::BitsetSeparator()
+    : numberOfVertices_(0),
+      wordsPerRow_(0)
+{
+}
+
+TDEF
+CDEF::BitsetSeparator(const Graph * graph)
+    : numberOfVertices_(0),
+      wordsPerRow_(0)
+{
+    initialize(CSRGraph(*graph));
+}
+
+TDEF
+CDEF::BitsetSeparator(const CSRGraph * graph)
+    : numberOfVertices_(0),
+      wordsPerRow_(0)
+{
+    initialize(*graph);
+}
+
+TDEF
+void CDEF::initialize(const CSRGraph & graph)
+{
+    typedef CSRGraph::AdjacencyIterator adjIt;
+
+    numberOfVertices_ = graph.numVertices();
+    wordsPerRow_ = (numberOfVertices_ + Traits::Bits - 1) / Traits::Bits;
+
+    // fill the adjacency rows
+    boost::shared_ptr<std::vector<Word> > adjacency(new std::vector<Word>(numberOfVertices_ * wordsPerRow_, Traits::zero()));
+    for(VertexIndexType v = 0; v < numberOfVertices_; ++v)
+        for(std::pair<adjIt, adjIt> p = graph.adjacentVertices(v); p.first != p.second; ++p.first)
+            Traits::set((*adjacency)[v * wordsPerRow_ + *p.first / Traits::Bits], *p.first % Traits::Bits);
+
+    adjacency_ = adjacency;
+}
+
+TDEF
+template <typename SeparatorVertexIterator>
+void CDEF::separate(SeparatorVertexIterator first, SeparatorVertexIterator last, result_type & separation) const
+{
+    // set the separator, as a sorted set
+    VertexSet & separator = separation.separator;
+    separator.assign(first, last);
+    std::sort(separator.begin(), separator.end());
+    separator.erase(std::unique(separator.begin(), separator.end()), separator.end());
+
+    // the component writer skips the separator vertices, so old entries have to be reset
+    separation.componentMap.assign(numberOfVertices_, UnassignedVertex());
+
+    resetRemaining(separator);
+    for(VertexSet::const_iterator it = separator.begin(); it != separator.end(); ++it)
+        separation.componentMap[*it] = SeparatorVertex();
+
+    // and grow the components, starting from the lowest remaining vertex
+    std::size_t noComponents = 0;
+    for(std::size_t w = 0; w < wordsPerRow_; ++w)
+        while(!Traits::isZero(remaining_[w]))
+        {
+            growComponent(w * Traits::Bits + Traits::lowest(remaining_[w]));
+
+            // reuse the vectors already there
+            if(separation.components.size() <= noComponents)
+                separation.components.resize(noComponents + 1);
+            separation.components[noComponents].clear();
+
+            fillComponent(separation.separator, noComponents++, separation);
+        }
+
+    separation.components.resize(noComponents);
+}
+
+TDEF
+template <typename SeparatorVertexIterator>
+bool CDEF::isMinimalSeparator(SeparatorVertexIterator first, SeparatorVertexIterator last) const
+{
+    VertexSet & separator = separator_;
+    separator.assign(first, last);
+    std::sort(separator.begin(), separator.end());
+    separator.erase(std::unique(separator.begin(), separator.end()), separator.end());
+
+    if(separator.empty())
+        return false;
+
+    resetRemaining(separator);
+
+    // a full component contains a neighbour of every separator vertex, so only grow from the neighbours of the first one
+    const Word * start = row(separator.front());
+    std::size_t fullComponents = 0;
+    for(std::size_t w = 0; w < wordsPerRow_; ++w)
+        while(!Traits::isZero(start[w] & remaining_[w]))
+        {
+            growComponent(w * Traits::Bits + Traits::lowest(start[w] & remaining_[w]));
+
+            if(isFullComponent(separator) && ++fullComponents == 2)
+                return true;
+        }
+
+    return false;
+}
+
+TDEF
+void CDEF::resetRemaining(const VertexSet & separator) const
+{
+    // all vertices, except the tail of the last word and the separator, are still to be assigned
+    remaining_.assign(wordsPerRow_, ~Traits::zero());
+    for(std::size_t bit = numberOfVertices_; bit < wordsPerRow_ * Traits::Bits; ++bit)
+        Traits::reset(remaining_[bit / Traits::Bits], bit % Traits::Bits);
+
+    for(VertexSet::const_iterator it = separator.begin(); it != separator.end(); ++it)
+        Traits::reset(remaining_[*it / Traits::Bits], *it % Traits::Bits);
+}
+
+TDEF
+bool CDEF::isFullComponent(const VertexSet & separator) const
+{
+    for(VertexSet::const_iterator it = separator.begin(); it != separator.end(); ++it)
+    {
+        const Word * adjacent = row(*it);
+
+        std::size_t w = 0;
+        while(w < wordsPerRow_ && Traits::isZero(adjacent[w] & component_[w]))
+            ++w;
+
+        if(w == wordsPerRow_)
+            return false;
+    }
+
+    return true;
+}
+
+TDEF
+void CDEF::growComponent(VertexIndexType source) const
+{
+    component_.assign(wordsPerRow_, Traits::zero());
+    frontier_.assign(wordsPerRow_, Traits::zero());
+    next_.resize(wordsPerRow_);
+
+    Traits::set(component_[source / Traits::Bits], source % Traits::Bits);
+    Traits::set(frontier_[source / Traits::Bits], source % Traits::Bits);
+    Traits::reset(remaining_[source / Traits::Bits], source % Traits::Bits);
+
+    while(true)
+    {
+        // the union of the neighbourhoods of the frontier
+        std::fill(next_.begin(), next_.end(), Traits::zero());
+        detail::RowAccumulator<Word> accumulate(&(*adjacency_)[0], wordsPerRow_, &next_[0]);
+        for(std::size_t w = 0; w < wordsPerRow_; ++w)
+            Traits::forEach(frontier_[w], w * Traits::Bits, accumulate);
+
+        // restricted to the unassigned vertices, which then move to the component
+        bool grown = false;
+        for(std::size_t w = 0; w < wordsPerRow_; ++w)
+        {
+            next_[w] &= remaining_[w];
+            remaining_[w] &= ~next_[w];
+            component_[w] |= next_[w];
+            grown = grown || !Traits::isZero(next_[w]);
+        }
+
+        if(!grown)
+            return;
+
+        frontier_.swap(next_);
+    }
+}
+
+TDEF
+void CDEF::fillComponent(const VertexSet & separator, std::size_t componentNumber, result_type & separation) const
+{
+    // add the separator vertices adjacent to the component
+    next_ = component_;
+    for(VertexSet::const_iterator it = separator.begin(); it != separator.end(); ++it)
+    {
+        const Word * adjacent = row(*it);
+        for(std::size_t w = 0; w < wordsPerRow_; ++w)
+            if(!Traits::isZero(adjacent[w] & component_[w]))
+            {
+                Traits::set(next_[*it / Traits::Bits], *it % Traits::Bits);
+                break;
+            }
+    }
+
+    // and write out in increasing order
+    ComponentWriter write(separation.componentMap, separation.components[componentNumber], componentNumber);
+    for(std::size_t w = 0; w < wordsPerRow_; ++w)
+        Traits::forEach(next_[w], w * Traits::Bits, write);
+}
+
+TDEF
+template <typename SeparatorVertexIterator>
+typename CDEF::result_type
+CDEF::operator()(SeparatorVertexIterator first, SeparatorVertexIterator last) const
+{
+    result_type separation;
+    separate(first, last, separation);
+
+    return separation;
+}
+
+TDEF
+template <typename SeparatorVertexIterator>
+typename CDEF::result_type
+CDEF::operator()(const std::pair<SeparatorVertexIterator, SeparatorVertexIterator> & separatorRange) const
+{
+    return operator ()(separatorRange.first, separatorRange.second);
+}
+
+#undef CDEF
+#undef TDEF
+
+} // namespace treeDAG
+
+#endif // TREEDAG_BITSETSEPARATOR_HXX
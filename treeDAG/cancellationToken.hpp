@@ -0,0 +1,28 @@
+#ifndef TREEDAG_CANCELLATIONTOKEN_HPP
+#define TREEDAG_CANCELLATIONTOKEN_HPP
+
+#include <boost/atomic.hpp>
+#include <boost/shared_ptr.hpp>
+
+namespace treeDAG {
+
+// a flag to stop a running computation from another thread. The copies share the flag, so a copy
+// can be kept by whoever may cancel, and the computation only reads it now and then
+class CancellationToken
+{
+public:
+    CancellationToken() : cancelled_(new boost::atomic<bool>(false)) {}
+
+    void cancel() { cancelled_->store(true, boost::memory_order_release); }
+    bool cancelled() const { return cancelled_->load(boost::memory_order_acquire); }
+
+    // allows the computation to run again
+    void reset() { cancelled_->store(false, boost::memory_order_release); }
+
+private:
+    boost::shared_ptr<boost::atomic<bool> > cancelled_;
+};
+
+} // namespace treeDAG
+
+#endif // TREEDAG_CANCELLATIONTOKEN_HPP
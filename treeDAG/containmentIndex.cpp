@@ -0,0 +1,164 @@
+#include "containmentIndex.hpp"
+#include <algorithm>
+
+namespace treeDAG {
+namespace {
+
+struct LexicographicalLess
+{
+    explicit LexicographicalLess(const SeparationStore & store) : store(store) {}
+
+    bool operator()(std::size_t lhs, std::size_t rhs) const
+    {
+        std::pair<SeparationView::VertexIterator, SeparationView::VertexIterator> l = separator(lhs);
+        std::pair<SeparationView::VertexIterator, SeparationView::VertexIterator> r = separator(rhs);
+
+        return std::lexicographical_compare(l.first, l.second, r.first, r.second);
+    }
+
+    std::pair<SeparationView::VertexIterator, SeparationView::VertexIterator> separator(std::size_t record) const
+    {
+        return (store.separations().first + record)->separator();
+    }
+
+    const SeparationStore & store;
+};
+
+// the separators [first, last) of the sorted order, which share their first depth vertices
+struct PrefixRange
+{
+    std::size_t first;
+    std::size_t last;
+    std::size_t depth;
+};
+
+struct RecordOutput
+{
+    explicit RecordOutput(std::vector<std::size_t> & records) : records(records) {}
+
+    void operator()(std::size_t record) { records.push_back(record); }
+
+    std::vector<std::size_t> & records;
+};
+
+struct ViewOutput
+{
+    ViewOutput(const SeparationStore & store, std::vector<SeparationView> & separations) : store(store), separations(separations) {}
+
+    void operator()(std::size_t record) { separations.push_back(*(store.separations().first + record)); }
+
+    const SeparationStore & store;
+    std::vector<SeparationView> & separations;
+};
+
+} // namespace
+
+
+ContainmentIndex::ContainmentIndex()
+{
+}
+
+
+void ContainmentIndex::build(const SeparationStore & store)
+{
+    clear();
+
+    // sort the separators, then every node covers a range with a common prefix
+    std::vector<std::size_t> sorted(store.size());
+    for(std::size_t i = 0; i < sorted.size(); ++i)
+        sorted[i] = i;
+
+    LexicographicalLess less(store);
+    std::sort(sorted.begin(), sorted.end(), less);
+
+    // the nodes are processed in the order they are created, which keeps the children of
+    // consecutive nodes consecutive
+    PrefixRange root = { 0, sorted.size(), 0 };
+    std::vector<PrefixRange> ranges(1, root);
+    vertices_.push_back(0);
+    records_.push_back(NoRecord());
+
+    for(std::size_t node = 0; node < ranges.size(); ++node)
+    {
+        const PrefixRange current = ranges[node];
+
+        // the prefix itself sorts first
+        std::size_t i = current.first;
+        if(i < current.last && std::size_t(less.separator(sorted[i]).second - less.separator(sorted[i]).first) == current.depth)
+            records_[node] = sorted[i++];
+
+        firstChild_.push_back(ranges.size());
+        while(i < current.last)
+        {
+            const VertexIndexType vertex = less.separator(sorted[i]).first[current.depth];
+
+            std::size_t j = i + 1;
+            while(j < current.last && less.separator(sorted[j]).first[current.depth] == vertex)
+                ++j;
+
+            PrefixRange child = { i, j, current.depth + 1 };
+            ranges.push_back(child);
+            vertices_.push_back(vertex);
+            records_.push_back(NoRecord());
+
+            i = j;
+        }
+    }
+
+    firstChild_.push_back(ranges.size());
+}
+
+
+void ContainmentIndex::clear()
+{
+    firstChild_.clear();
+    vertices_.clear();
+    records_.clear();
+}
+
+
+void ContainmentIndex::findSubsets(const VertexSet & set, std::vector<std::size_t> & records) const
+{
+    RecordOutput output(records);
+    if(!records_.empty())
+        collect(0, set.begin(), set.end(), output);
+}
+
+
+void ContainmentIndex::findSubsets(const VertexSet & set, const SeparationStore & store, std::vector<SeparationView> & separations) const
+{
+    ViewOutput output(store, separations);
+    if(!records_.empty())
+        collect(0, set.begin(), set.end(), output);
+}
+
+
+template <typename Output>
+void ContainmentIndex::collect(std::size_t node, VertexSet::const_iterator first, VertexSet::const_iterator last, Output & output) const
+{
+    // both the children and the set are sorted, so the search continues where the previous one ended
+    std::vector<boost::uint32_t>::const_iterator childIt = vertices_.begin() + firstChild_[node];
+    const std::vector<boost::uint32_t>::const_iterator childEnd = vertices_.begin() + firstChild_[node + 1];
+
+    for(; first != last && childIt != childEnd; ++first)
+    {
+        childIt = std::lower_bound(childIt, childEnd, *first);
+        if(childIt == childEnd || *childIt != *first)
+            continue;
+
+        const std::size_t child = childIt - vertices_.begin();
+        if(records_[child] != NoRecord())
+            output(records_[child]);
+
+        collect(child, first + 1, last, output);
+    }
+}
+
+
+std::size_t ContainmentIndex::memoryUsage() const
+{
+    return (firstChild_.capacity() + vertices_.capacity() + records_.capacity()) * sizeof(boost::uint32_t);
+}
+
+
+} // namespace treeDAG
@@ -0,0 +1,45 @@
+#ifndef TREEDAG_CONTAINMENTINDEX_HPP
+#define TREEDAG_CONTAINMENTINDEX_HPP
+
+#include "separatorConfig.hpp"
+#include "separationStore.hpp"
+#include <boost/cstdint.hpp>
+
+namespace treeDAG {
+
+// a prefix trie over the sorted separators of a separation store, which finds the stored separators
+// contained in a set. Only the prefixes which are subsets of the set are visited, so the work follows
+// the number of hits instead of the 2^|set| subsets. The store should not change after building
+class ContainmentIndex : public SeparatorConfig
+{
+public:
+    ContainmentIndex();
+
+    void build(const SeparationStore & store);
+    void clear();
+
+    // appends the records of the stored separators which are subsets of the sorted set
+    void findSubsets(const VertexSet & set, std::vector<std::size_t> & records) const;
+
+    // appends the views of the stored separators which are subsets of the sorted set, without
+    // collecting the records first. The store should be the one the index was built on
+    void findSubsets(const VertexSet & set, const SeparationStore & store, std::vector<SeparationView> & separations) const;
+
+    std::size_t memoryUsage() const;
+
+private:
+    template <typename Output>
+    void collect(std::size_t node, VertexSet::const_iterator first, VertexSet::const_iterator last, Output & output) const;
+
+    static boost::uint32_t NoRecord() { return boost::uint32_t(-1); }
+
+    // the nodes are numbered breadth first from the root 0, so the children of node i are
+    // [firstChild[i], firstChild[i+1]), sorted on their vertex
+    std::vector<boost::uint32_t> firstChild_;
+    std::vector<boost::uint32_t> vertices_;
+    std::vector<boost::uint32_t> records_;
+};
+
+} // namespace treeDAG
+
+#endif // TREEDAG_CONTAINMENTINDEX_HPP
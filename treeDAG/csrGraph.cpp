@@ -0,0 +1,163 @@
+#include "csrGraph.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace treeDAG {
+
+CSRGraph::CSRGraph()
+    : offsets_(1, 0)
+{
+}
+
+CSRGraph::CSRGraph(const Graph & graph)
+    : offsets_(1, 0)
+{
+    typedef boost::graph_traits<Graph>::adjacency_iterator adjIt;
+
+    const std::size_t graphSize = boost::num_vertices(graph);
+    offsets_.reserve(graphSize + 1);
+
+    for(VertexIndexType v = 0; v < graphSize; ++v)
+    {
+        for(std::pair<adjIt, adjIt> p = boost::adjacent_vertices(v, graph); p.first != p.second; ++p.first)
+            targets_.push_back(*p.first);
+
+        offsets_.push_back(targets_.size());
+    }
+
+    sortAdjacency();
+    checkAdjacency();
+}
+
+std::pair<CSRGraph::VertexIterator, CSRGraph::VertexIterator> CSRGraph::vertices() const
+{
+    return std::make_pair(VertexIterator(0), VertexIterator(numVertices()));
+}
+
+std::pair<CSRGraph::AdjacencyIterator, CSRGraph::AdjacencyIterator> CSRGraph::adjacentVertices(VertexIndexType vertex) const
+{
+    const VertexIndexType * targets = targets_.empty() ? 0 : &targets_[0];
+    return std::make_pair(targets + offsets_[vertex], targets + offsets_[vertex + 1]);
+}
+
+std::pair<CSRGraph::OutEdgeIterator, CSRGraph::OutEdgeIterator> CSRGraph::outEdges(VertexIndexType vertex) const
+{
+    std::pair<AdjacencyIterator, AdjacencyIterator> targets = adjacentVertices(vertex);
+    return std::make_pair(OutEdgeIterator(vertex, targets.first), OutEdgeIterator(vertex, targets.second));
+}
+
+CSRGraph CSRGraph::induced(const VertexSet & vertices) const
+{
+    CSRGraph graph;
+    graph.offsets_.reserve(vertices.size() + 1);
+
+    // the neighbours are sorted, and so are their positions in the set
+    for(VertexSet::const_iterator it = vertices.begin(); it != vertices.end(); ++it)
+    {
+        for(std::pair<AdjacencyIterator, AdjacencyIterator> p = adjacentVertices(*it); p.first != p.second; ++p.first)
+        {
+            VertexSet::const_iterator position = std::lower_bound(vertices.begin(), vertices.end(), *p.first);
+            if(position != vertices.end() && *position == *p.first)
+                graph.targets_.push_back(position - vertices.begin());
+        }
+
+        graph.offsets_.push_back(graph.targets_.size());
+    }
+
+    return graph;
+}
+
+boost::uint64_t CSRGraph::fingerprint() const
+{
+    // fnv-1a over the vertex count and the sorted neighbour lists
+    const boost::uint64_t prime = 1099511628211ull;
+    boost::uint64_t hash = 14695981039346656037ull;
+
+    hash = (hash ^ numVertices()) * prime;
+    for(std::size_t v = 0; v < numVertices(); ++v)
+    {
+        hash = (hash ^ degree(v)) * prime;
+        for(std::pair<AdjacencyIterator, AdjacencyIterator> p = adjacentVertices(v); p.first != p.second; ++p.first)
+            hash = (hash ^ *p.first) * prime;
+    }
+
+    return hash;
+}
+
+void CSRGraph::sortAdjacency()
+{
+    // sorted neighbour lists, so the scans go in increasing memory order
+    for(std::size_t v = 0; v + 1 < offsets_.size(); ++v)
+        std::sort(targets_.begin() + offsets_[v], targets_.begin() + offsets_[v + 1]);
+}
+
+void CSRGraph::checkAdjacency() const
+{
+    // on sorted neighbour lists: every target is a vertex other than the source, and the edge is
+    // stored as often in the other direction, so numEdges() is half the targets
+    for(VertexIndexType v = 0; v < numVertices(); ++v)
+    {
+        std::pair<AdjacencyIterator, AdjacencyIterator> p = adjacentVertices(v);
+        while(p.first != p.second)
+        {
+            const VertexIndexType u = *p.first;
+            if(u >= numVertices())
+                throw std::logic_error("CSRGraph: a target is not a vertex of the graph");
+            if(u == v)
+                throw std::logic_error("CSRGraph: self loops are not supported");
+
+            // the parallel copies of the edge are next to each other
+            const AdjacencyIterator next = std::upper_bound(p.first, p.second, u);
+            std::pair<AdjacencyIterator, AdjacencyIterator> reverse = adjacentVertices(u);
+            reverse = std::equal_range(reverse.first, reverse.second, v);
+            if(next - p.first != reverse.second - reverse.first)
+                throw std::logic_error("CSRGraph: every edge should be stored in both directions");
+
+            p.first = next;
+        }
+    }
+}
+
+
+
+std::size_t num_vertices(const CSRGraph & graph)
+{
+    return graph.numVertices();
+}
+
+std::size_t num_edges(const CSRGraph & graph)
+{
+    return graph.numEdges();
+}
+
+std::size_t out_degree(CSRGraph::VertexIndexType vertex, const CSRGraph & graph)
+{
+    return graph.degree(vertex);
+}
+
+std::pair<CSRGraph::VertexIterator, CSRGraph::VertexIterator> vertices(const CSRGraph & graph)
+{
+    return graph.vertices();
+}
+
+std::pair<CSRGraph::AdjacencyIterator, CSRGraph::AdjacencyIterator> adjacent_vertices(CSRGraph::VertexIndexType vertex, const CSRGraph & graph)
+{
+    return graph.adjacentVertices(vertex);
+}
+
+std::pair<CSRGraph::OutEdgeIterator, CSRGraph::OutEdgeIterator> out_edges(CSRGraph::VertexIndexType vertex, const CSRGraph & graph)
+{
+    return graph.outEdges(vertex);
+}
+
+CSRGraph::VertexIndexType source(const CSRGraph::Edge & edge, const CSRGraph &)
+{
+    return edge.first;
+}
+
+CSRGraph::VertexIndexType target(const CSRGraph::Edge & edge, const CSRGraph &)
+{
+    return edge.second;
+}
+
+} // namespace treeDAG
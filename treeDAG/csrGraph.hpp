@@ -0,0 +1,120 @@
+#ifndef TREEDAG_CSRGRAPH_HPP
+#define TREEDAG_CSRGRAPH_HPP
+
+#include "separatorConfig.hpp"
+#include <boost/iterator/counting_iterator.hpp>
+#include <boost/iterator/iterator_facade.hpp>
+#include <boost/cstdint.hpp>
+
+namespace treeDAG {
+
+// an undirected graph in compressed sparse row format: the neighbours of vertex v are stored
+// contiguously in targets[offsets[v], offsets[v+1]). Every edge should be stored in both directions,
+// and there are no self loops: the constructors throw a std::logic_error otherwise
+class CSRGraph : public SeparatorConfig
+{
+public:
+    typedef const VertexIndexType *                         AdjacencyIterator;
+    typedef boost::counting_iterator<VertexIndexType>       VertexIterator;
+
+    // an edge is the pair of its end points, the out edges of a vertex have it as the first one
+    typedef std::pair<VertexIndexType, VertexIndexType>     Edge;
+
+    class OutEdgeIterator : public boost::iterator_facade<OutEdgeIterator, const Edge, boost::random_access_traversal_tag, Edge>
+    {
+    public:
+        OutEdgeIterator() : source_(0), target_(0) {}
+        OutEdgeIterator(VertexIndexType source, AdjacencyIterator target) : source_(source), target_(target) {}
+
+    private:
+        friend class boost::iterator_core_access;
+
+        Edge dereference() const { return Edge(source_, *target_); }
+        bool equal(const OutEdgeIterator & other) const { return target_ == other.target_; }
+        void increment() { ++target_; }
+        void decrement() { --target_; }
+        void advance(std::ptrdiff_t n) { target_ += n; }
+        std::ptrdiff_t distance_to(const OutEdgeIterator & other) const { return other.target_ - target_; }
+
+        VertexIndexType source_;
+        AdjacencyIterator target_;
+    };
+
+    CSRGraph();
+    explicit CSRGraph(const Graph & graph);
+
+    // from existing csr data: numberOfVertices + 1 nondecreasing offsets, and the targets they index
+    template <typename OffsetIterator, typename TargetIterator>
+    CSRGraph(OffsetIterator firstOffset, OffsetIterator lastOffset, TargetIterator firstTarget);
+
+    // from a list of undirected edges between distinct vertices below numberOfVertices
+    template <typename EdgeIterator>
+    static CSRGraph fromEdges(std::size_t numberOfVertices, EdgeIterator firstEdge, EdgeIterator lastEdge);
+
+    std::size_t numVertices() const { return offsets_.size() - 1; }
+    std::size_t numEdges() const { return targets_.size() / 2; }
+    std::size_t degree(VertexIndexType vertex) const { return offsets_[vertex + 1] - offsets_[vertex]; }
+
+    std::pair<VertexIterator, VertexIterator> vertices() const;
+    std::pair<AdjacencyIterator, AdjacencyIterator> adjacentVertices(VertexIndexType vertex) const;
+    std::pair<OutEdgeIterator, OutEdgeIterator> outEdges(VertexIndexType vertex) const;
+
+    const std::vector<std::size_t> & offsets() const { return offsets_; }
+    const VertexSet & targets() const { return targets_; }
+
+    // the subgraph induced by a sorted set of vertices, its vertex i is the i-th vertex of the set. The
+    // cost is in the degrees of the set, the rest of the graph is not visited
+    CSRGraph induced(const VertexSet & vertices) const;
+
+    // a 64 bit hash of the structure, the same graph with the same vertex numbering gives the same value
+    boost::uint64_t fingerprint() const;
+
+private:
+    void sortAdjacency();
+    void checkAdjacency() const;
+
+    std::vector<std::size_t> offsets_;
+    VertexSet targets_;
+};
+
+// boost graph library interface: a vertex list, adjacency and incidence graph, so the csr graph can be
+// used in the bgl algorithms needing only these. There is no edge list and no property map, the
+// vertices are their own indices
+std::size_t num_vertices(const CSRGraph & graph);
+std::size_t num_edges(const CSRGraph & graph);
+std::size_t out_degree(CSRGraph::VertexIndexType vertex, const CSRGraph & graph);
+std::pair<CSRGraph::VertexIterator, CSRGraph::VertexIterator> vertices(const CSRGraph & graph);
+std::pair<CSRGraph::AdjacencyIterator, CSRGraph::AdjacencyIterator> adjacent_vertices(CSRGraph::VertexIndexType vertex, const CSRGraph & graph);
+std::pair<CSRGraph::OutEdgeIterator, CSRGraph::OutEdgeIterator> out_edges(CSRGraph::VertexIndexType vertex, const CSRGraph & graph);
+CSRGraph::VertexIndexType source(const CSRGraph::Edge & edge, const CSRGraph & graph);
+CSRGraph::VertexIndexType target(const CSRGraph::Edge & edge, const CSRGraph & graph);
+
+} // namespace treeDAG
+
+namespace boost {
+
+template <>
+struct graph_traits<treeDAG::CSRGraph>
+{
+    struct traversal_category : public adjacency_graph_tag, public vertex_list_graph_tag, public incidence_graph_tag {};
+
+    typedef treeDAG::CSRGraph::VertexIndexType          vertex_descriptor;
+    typedef treeDAG::CSRGraph::Edge                     edge_descriptor;
+    typedef undirected_tag                              directed_category;
+    typedef allow_parallel_edge_tag                     edge_parallel_category;
+
+    typedef treeDAG::CSRGraph::AdjacencyIterator        adjacency_iterator;
+    typedef treeDAG::CSRGraph::OutEdgeIterator          out_edge_iterator;
+    typedef treeDAG::CSRGraph::VertexIterator           vertex_iterator;
+    typedef std::size_t                                 vertices_size_type;
+    typedef std::size_t                                 edges_size_type;
+    typedef std::size_t                                 degree_size_type;
+
+    static vertex_descriptor null_vertex() { return treeDAG::CSRGraph::UnassignedVertex(); }
+};
+
+} // namespace boost
+
+#include "csrGraph.hxx"
+
+#endif // TREEDAG_CSRGRAPH_HPP
@@ -0,0 +1,62 @@
+#ifndef TREEDAG_CSRGRAPH_HXX
+#define TREEDAG_CSRGRAPH_HXX
+
+#include "csrGraph.hpp"
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+
+namespace treeDAG {
+
+template <typename OffsetIterator, typename TargetIterator>
+CSRGraph::CSRGraph(OffsetIterator firstOffset, OffsetIterator lastOffset, TargetIterator firstTarget)
+    : offsets_(firstOffset, lastOffset)
+{
+    if(offsets_.empty() || offsets_.front() != 0)
+        throw std::logic_error("CSRGraph: the offsets should start at zero");
+    if(std::adjacent_find(offsets_.begin(), offsets_.end(), std::greater<std::size_t>()) != offsets_.end())
+        throw std::logic_error("CSRGraph: the offsets should not decrease");
+
+    targets_.assign(firstTarget, firstTarget + offsets_.back());
+    sortAdjacency();
+    checkAdjacency();
+}
+
+template <typename EdgeIterator>
+CSRGraph CSRGraph::fromEdges(std::size_t numberOfVertices, EdgeIterator firstEdge, EdgeIterator lastEdge)
+{
+    CSRGraph graph;
+    graph.offsets_.assign(numberOfVertices + 1, 0);
+
+    // count the degrees
+    for(EdgeIterator it = firstEdge; it != lastEdge; ++it)
+    {
+        if(it->first >= numberOfVertices || it->second >= numberOfVertices)
+            throw std::logic_error("CSRGraph: an edge end point is not a vertex of the graph");
+        if(it->first == it->second)
+            throw std::logic_error("CSRGraph: self loops are not supported");
+
+        ++graph.offsets_[it->first + 1];
+        ++graph.offsets_[it->second + 1];
+    }
+
+    for(std::size_t v = 0; v < numberOfVertices; ++v)
+        graph.offsets_[v + 1] += graph.offsets_[v];
+
+    // and fill the targets
+    std::vector<std::size_t> position(graph.offsets_.begin(), graph.offsets_.end() - 1);
+    graph.targets_.resize(graph.offsets_.back());
+
+    for(EdgeIterator it = firstEdge; it != lastEdge; ++it)
+    {
+        graph.targets_[position[it->first]++] = it->second;
+        graph.targets_[position[it->second]++] = it->first;
+    }
+
+    graph.sortAdjacency();
+    return graph;
+}
+
+} // namespace treeDAG
+
+#endif // TREEDAG_CSRGRAPH_HXX
@@ -1,27 +1,236 @@
 
 #include "decomposer.hpp"
-#include "util/nChooseKIterator.hpp"
-#include "util/combinationIterator.hpp"
+#include "treewidthBound.hpp"
+#include "util/bitsetWord.hpp"
+
+#include <boost/bind.hpp>
+#include <boost/thread.hpp>
 
 
 namespace treeDAG {
 
+namespace {
+
+struct SeparatorLess
+{
+    bool operator()(const SeparationView & lhs, const SeparationView & rhs) const
+    {
+        return std::lexicographical_compare(lhs.separator().first, lhs.separator().second, rhs.separator().first, rhs.separator().second);
+    }
+};
+
+// the seed positions when there is no seed
+const std::vector<std::size_t> NoPositions;
+
+} // namespace
+
+
 Decomposer::Decomposer(const Graph * graph, std::size_t k)
-    : cache_(k, graph),
+    : ownedGraph_(new CSRGraph(*graph)),
+      cache_(new SeparatorCache(k, ownedGraph_.get())),
+      sharedCache_(false),
       k_(k),
-      graph_(graph)
+      graph_(ownedGraph_.get()),
+      numberOfThreads_(1),
+      lowerBound_(0),
+      initialized_(false),
+      cacheInitialized_(false),
+      incremental_(false),
+      rootNode_(DecompositionDAG::InvalidNode()),
+      exploredK_(0),
+      status_(STATUS_Complete),
+      measuredNodes_(0),
+      measuredDAGBytes_(0),
+      measuredCacheBytes_(0)
+{
+}
+
+Decomposer::Decomposer(const CSRGraph * graph, std::size_t k)
+    : cache_(new SeparatorCache(k, graph)),
+      sharedCache_(false),
+      k_(k),
+      graph_(graph),
+      numberOfThreads_(1),
+      lowerBound_(0),
+      initialized_(false),
+      cacheInitialized_(false),
+      incremental_(false),
+      rootNode_(DecompositionDAG::InvalidNode()),
+      exploredK_(0),
+      status_(STATUS_Complete),
+      measuredNodes_(0),
+      measuredDAGBytes_(0),
+      measuredCacheBytes_(0)
+{
+}
+
+Decomposer::Decomposer(const CSRGraph * graph, std::size_t k, const boost::shared_ptr<SeparatorCache> & cache)
+    : cache_(cache),
+      sharedCache_(true),
+      k_(k),
+      graph_(graph),
+      numberOfThreads_(1),
+      lowerBound_(0),
+      initialized_(false),
+      cacheInitialized_(false),
+      incremental_(false),
+      rootNode_(DecompositionDAG::InvalidNode()),
+      exploredK_(0),
+      status_(STATUS_Complete),
+      measuredNodes_(0),
+      measuredDAGBytes_(0),
+      measuredCacheBytes_(0)
+{
+    // the same structure in another object is the same graph
+    const CSRGraph * cacheGraph = cache_->graph();
+    if(cacheGraph != graph_ && (cacheGraph == 0 || cacheGraph->numVertices() != graph_->numVertices() || cacheGraph->fingerprint() != graph_->fingerprint()))
+        throw std::logic_error("Decomposer: the shared cache was built for another graph");
+
+    checkCache();
+}
+
+Decomposer::Decomposer(const CSRGraph * graph, std::size_t k, VertexOrdering::OrderingMethod ordering)
+    : ordering_(new VertexOrdering(graph, ordering)),
+      cache_(new SeparatorCache(k, &ordering_->orderedGraph())),
+      sharedCache_(false),
+      k_(k),
+      graph_(&ordering_->orderedGraph()),
+      numberOfThreads_(1),
+      lowerBound_(0),
+      initialized_(false),
+      cacheInitialized_(false),
+      incremental_(false),
+      rootNode_(DecompositionDAG::InvalidNode()),
+      exploredK_(0),
+      status_(STATUS_Complete),
+      measuredNodes_(0),
+      measuredDAGBytes_(0),
+      measuredCacheBytes_(0)
 {
 }
 
 Decomposer::Decomposer()
-    : k_(0),
-      graph_(0)
+    : cache_(new SeparatorCache()),
+      sharedCache_(false),
+      k_(0),
+      graph_(0),
+      numberOfThreads_(1),
+      lowerBound_(0),
+      initialized_(false),
+      cacheInitialized_(false),
+      incremental_(false),
+      rootNode_(DecompositionDAG::InvalidNode()),
+      exploredK_(0),
+      status_(STATUS_Complete),
+      measuredNodes_(0),
+      measuredDAGBytes_(0),
+      measuredCacheBytes_(0)
+{
+}
+
+void Decomposer::setNumberOfThreads(std::size_t numberOfThreads)
+{
+    numberOfThreads_ = numberOfThreads;
+}
+
+std::size_t Decomposer::numberOfThreads() const
+{
+    return numberOfThreads_;
+}
+
+void Decomposer::setIncremental(bool incremental)
+{
+    incremental_ = incremental;
+}
+
+bool Decomposer::incremental() const
+{
+    return incremental_;
+}
+
+void Decomposer::increaseK(std::size_t k)
+{
+    if(k < k_)
+        throw std::logic_error("Decomposer: k can only be increased");
+
+    k_ = k;
+    if(sharedCache_)
+        return;
+
+    cache_->increaseK(k);
+
+    // the cache was skipped while k was below the lower bound
+    if(initialized_ && !cacheInitialized_ && feasible())
+    {
+        cache_->initialize();
+        cacheInitialized_ = true;
+    }
+}
+
+std::size_t Decomposer::k() const
+{
+    return k_;
+}
+
+void Decomposer::setBudget(const Budget & budget)
+{
+    budget_ = budget;
+}
+
+const Decomposer::Budget & Decomposer::budget() const
+{
+    return budget_;
+}
+
+void Decomposer::setCancellationToken(const CancellationToken & token)
+{
+    token_ = token;
+}
+
+CancellationToken Decomposer::cancellationToken() const
+{
+    return token_;
+}
+
+void Decomposer::setProgressCallback(const ProgressCallback & callback)
 {
+    callback_ = callback;
+}
+
+Decomposer::Status Decomposer::status() const
+{
+    return status_;
+}
+
+const Decomposer::Progress & Decomposer::progress() const
+{
+    return progress_;
+}
+
+std::size_t Decomposer::lowerBound() const
+{
+    return lowerBound_;
+}
+
+bool Decomposer::feasible() const
+{
+    return lowerBound_ <= k_;
 }
 
 void  Decomposer::initialize()
 {
-    cache_.initialize();
+    initialized_ = true;
+    if(graph_)
+        lowerBound_ = TreewidthBound(graph_).bound();
+
+    if(!feasible())
+        return;
+
+    if(!sharedCache_)
+    {
+        cache_->initialize();
+        cacheInitialized_ = true;
+    }
 }
 
 
@@ -30,13 +239,64 @@ void Decomposer::writeDot(std::ostream & stream) const
     dag_.write_dot(stream);
 }
 
-void Decomposer::processRoot()
+Decomposer::Status Decomposer::interruption() const
+{
+    if(token_.cancelled())
+        return STATUS_Cancelled;
+
+    if(budget_.time != boost::chrono::nanoseconds::zero() && boost::chrono::steady_clock::now() - start_ >= budget_.time)
+        return STATUS_TimeBudget;
+
+    return STATUS_Complete;
+}
+
+
+Decomposer::Status Decomposer::exhaustion()
 {
-    typedef util::NChooseKIterator<VertexSet::const_iterator> it;
+    const std::size_t nodes = exploredDAG().numberOfNodes();
+
+    // measuring walks the whole dag, so it is only done again after the dag grew by an eighth
+    if(measuredNodes_ == 0 || nodes >= measuredNodes_ + measuredNodes_ / 8)
+    {
+        measuredNodes_ = std::max<std::size_t>(nodes, 1);
+        measuredDAGBytes_ = exploredDAG().memoryUsage();
+        measuredCacheBytes_ = cache_->memoryUsage();
+    }
 
+    progress_.nodes = nodes;
+    progress_.bytes = measuredCacheBytes_ + measuredDAGBytes_ / measuredNodes_ * nodes;
+
+    if(budget_.nodes != 0 && nodes > budget_.nodes)
+        return STATUS_NodeBudget;
+
+    if(budget_.bytes != 0 && progress_.bytes > budget_.bytes)
+        return STATUS_MemoryBudget;
+
+    return STATUS_Complete;
+}
+
+
+void Decomposer::checkCache() const
+{
+    if(cache_->k() < k_)
+        throw std::logic_error("Decomposer: the cache should hold the separators up to k");
+}
+
+
+void Decomposer::startRun()
+{
+    start_ = boost::chrono::steady_clock::now();
+    status_ = STATUS_Complete;
+    progress_ = Progress();
+    measuredNodes_ = 0;
+}
+
+
+void Decomposer::processRoot()
+{
     // create the root graph
     SubgraphNodeData data;
-    const std::size_t graphSize = boost::num_vertices(*graph_);
+    const std::size_t graphSize = graph_->numVertices();
     VertexSet::const_iterator sepIt = roots_.begin();
 
     // loop over all vertices
@@ -50,146 +310,436 @@ void Decomposer::processRoot()
             data.activeVertices.push_back(*sepIt++);
     }
 
-    DecompositionDAG::NodeDescriptor node = dag_.addSubgraph(data);
+    rootNode_ = exploredDAG().addSubgraph(data);
+    processBatch(std::vector<DecompositionDAG::NodeDescriptor>(1, rootNode_), 0);
+}
+
 
-    // storage for the already added
-    boost::unordered_set<UsedSeparatorNodeSet> addedCliqueNodes;
+void Decomposer::processExplored()
+{
+    typedef boost::graph_traits<DecompositionDAG::Structure>::vertex_iterator NodeIterator;
 
-    // loop over all combinations
-    const std::size_t rootSize = roots_.size();
-    const std::size_t maxToAdd = k_ + 1 - rootSize;
-    const VertexSet & otherVertices = data.otherVertices;
+    // the cliques up to the explored k + 1 vertices only contain the separators known then, so they
+    // were all tried before. The larger ones are tried in every subgraph node, in the order of the dag
+    std::vector<DecompositionDAG::NodeDescriptor> explored;
+    for(std::pair<NodeIterator, NodeIterator> p = boost::vertices(exploredDAG().structure()); p.first != p.second; ++p.first)
+        if(exploredDAG().nodeType(*p.first) == DecompositionDAG::NODE_Subgraph)
+            explored.push_back(*p.first);
 
-    for(std::size_t extraCount = 0; extraCount <= maxToAdd; ++extraCount)
+    std::vector<DecompositionDAG::NodeDescriptor> batch;
+    for(std::size_t first = 0; first < explored.size() && status_ == STATUS_Complete; first += BatchSize)
     {
-        for(std::pair<it, it> p = util::make_n_choose_k_iterators(otherVertices.begin(), otherVertices.end(), extraCount); p.first != p.second; ++p.first)
-        {
-            const VertexSet & extraVertices = *p.first;
+        batch.assign(explored.begin() + first, explored.begin() + std::min(first + BatchSize, explored.size()));
+        processBatch(batch, exploredK_ + 2);
+    }
+}
 
-            VertexSet newClique(rootSize + extraCount);
-            std::merge(data.activeVertices.begin(), data.activeVertices.end(), extraVertices.begin(), extraVertices.end(), newClique.begin());
 
-            tryClique(node, VertexSet(), newClique, addedCliqueNodes);
-        }
+void Decomposer::processBatch(const std::vector<DecompositionDAG::NodeDescriptor> & batch, std::size_t firstCliqueSize)
+{
+    std::vector<std::vector<CliqueCandidate> > results(batch.size());
+    boost::atomic<std::size_t> next(0);
+
+    std::size_t threadCount = numberOfThreads_ == 0 ? boost::thread::hardware_concurrency() : numberOfThreads_;
+    threadCount = std::min(std::max<std::size_t>(threadCount, 1), batch.size());
+
+    // the threads only read the dag and the cache, every node in the batch is taken by the first idle thread
+    if(threadCount <= 1)
+        findCliquesWorker(batch, firstCliqueSize, results, next);
+    else
+    {
+        boost::thread_group threads;
+        for(std::size_t i = 0; i < threadCount; ++i)
+            threads.create_thread(boost::bind(&Decomposer::findCliquesWorker, this, boost::cref(batch), firstCliqueSize, boost::ref(results), boost::ref(next)));
+        threads.join_all();
+    }
+
+    // add in the order of the batch, this keeps the dag independent of the number of threads. The nodes
+    // skipped after an interruption have no cliques, so the clean up removes them
+    for(std::size_t i = 0; i < batch.size(); ++i)
+    {
+        addCliques(batch[i], results[i]);
+        for(std::vector<CliqueCandidate>::const_iterator it = results[i].begin(); it != results[i].end(); ++it)
+            progress_.separatorHits += it->separators.size();
     }
 
+    status_ = interruption();
+    const Status exhausted = exhaustion();
+    if(status_ == STATUS_Complete)
+        status_ = exhausted;
+
+    progress_.queueDepth = todo_.size();
+    progress_.time = boost::chrono::steady_clock::now() - start_;
+    if(callback_)
+        callback_(progress_);
 }
 
-void Decomposer::process(DecompositionDAG::NodeDescriptor node)
+
+void Decomposer::findCliquesWorker(const std::vector<DecompositionDAG::NodeDescriptor> & batch, std::size_t firstCliqueSize, std::vector<std::vector<CliqueCandidate> > & results, boost::atomic<std::size_t> & next) const
 {
-    boost::unordered_set<UsedSeparatorNodeSet> addedCliqueNodes;
+    CliqueWorkspace workspace;
 
-    // get the data
-    const SubgraphNodeData & data = *dag_.subgraphNodeData(node);
+    for(std::size_t i = next++; i < batch.size() && interruption() == STATUS_Complete; i = next++)
+    {
+        assert(exploredDAG().nodeType(batch[i]) == DecompositionDAG::NODE_Subgraph);
+        findCliques(batch[i], firstCliqueSize, workspace, results[i]);
+    }
+}
 
-    // how many to add?
-    std::size_t toAdd = k_ - data.activeVertices.size() + 1;
-    assert(toAdd > 0);
 
-    // loop over all possible nodes to add
-    typedef util::NChooseKIterator<VertexSet::const_iterator> it;
+void Decomposer::findCliques(DecompositionDAG::NodeDescriptor node, std::size_t firstCliqueSize, CliqueWorkspace & workspace, std::vector<CliqueCandidate> & cliques) const
+{
+    typedef boost::graph_traits<DecompositionDAG::Structure>::adjacency_iterator adjIt;
 
+    const SubgraphNodeData & data = *exploredDAG().subgraphNodeData(node);
+    const bool root = node == rootNode_;
 
-    // we will try clique sizes from activecount+1 -> k + 1
-    for(std::size_t cur = 1; cur <= toAdd; ++cur)
+    // storage for the already added, including the cliques of an earlier k
+    workspace.added.clear();
+    for(std::pair<adjIt, adjIt> p = boost::adjacent_vertices(node, exploredDAG().structure()); p.first != p.second; ++p.first)
     {
-        // are there still enough other vertices left to choose from?
-        if(data.otherVertices.size() <= cur)
+        workspace.key.clear();
+        for(std::pair<adjIt, adjIt> sep = boost::adjacent_vertices(*p.first, exploredDAG().structure()); sep.first != sep.second; ++sep.first)
+            workspace.key.push_back(*exploredDAG().separatorNodeData(*sep.first));
+        std::sort(workspace.key.begin(), workspace.key.end());
+        workspace.added.insert(std::make_pair(workspace.key, NoClique()));
+    }
+
+    // a clique is only kept when it contains a stored separator with a new vertex, so when the cache
+    // can list the separators inside the subgraph the cliques are grown from these instead of trying
+    // every subset of the other vertices
+    const bool seeded = cache_->complete();
+    if(seeded)
+        findSeeds(data, root, workspace);
+
+    const std::size_t activeCount = data.activeVertices.size();
+    const std::size_t otherCount = data.otherVertices.size();
+
+    // the root tries all cliques containing the roots, including the roots alone. The other nodes
+    // try clique sizes from activecount+1 -> k + 1, while there are still enough other vertices left
+    const std::size_t firstCount = std::max<std::size_t>(root ? 0 : 1, firstCliqueSize > activeCount ? firstCliqueSize - activeCount : 0);
+    const std::size_t lastCount = k_ + 1 - activeCount;
+    assert(root || lastCount > 0);
+
+    for(std::size_t count = firstCount; count <= lastCount; ++count)
+    {
+        if(!root && otherCount <= count)
             break;
 
-        for(std::pair<it, it> p = util::make_n_choose_k_iterators(data.otherVertices.begin(), data.otherVertices.end(), cur); p.first != p.second; ++p.first)
-            tryClique(node, data.activeVertices, *p.first, addedCliqueNodes);
+        if(!seeded)
+        {
+            enumerateCliques(data, count, !root, NoSeed(), workspace, cliques);
+            continue;
+        }
+
+        for(std::size_t seed = 0; seed < workspace.seeds.size(); ++seed)
+        {
+            // the separator should be a proper subset of the clique
+            if(workspace.seeds[seed].separatorSize() < activeCount + count)
+                enumerateCliques(data, count, !root, seed, workspace, cliques);
+        }
     }
+
+    // the cliques are added in the order of the subset enumeration, which does not depend on the seeds
+    std::stable_sort(cliques.begin(), cliques.end(), &Decomposer::enumeratedBefore);
+}
+
+
+bool Decomposer::enumeratedBefore(const CliqueCandidate & lhs, const CliqueCandidate & rhs)
+{
+    // the smaller cliques come first, and the subsets of a size start with the last vertices: the
+    // combinations of the other vertices were enumerated in the lexicographical order of their masks
+    if(lhs.clique.size() != rhs.clique.size())
+        return lhs.clique.size() < rhs.clique.size();
+
+    return std::lexicographical_compare(rhs.clique.begin(), rhs.clique.end(), lhs.clique.begin(), lhs.clique.end());
 }
 
 
-void Decomposer::tryClique(DecompositionDAG::NodeDescriptor subgraphNode, const VertexSet & oldVertices, const VertexSet & newVertices, boost::unordered_set<UsedSeparatorNodeSet> & cache)
+void Decomposer::findSeeds(const SubgraphNodeData & data, bool root, CliqueWorkspace & workspace) const
 {
-    std::size_t curK = oldVertices.size() + newVertices.size() - 1;
+    VertexSet & subgraph = workspace.subgraph;
+    subgraph.clear();
+    std::merge(data.activeVertices.begin(), data.activeVertices.end(), data.otherVertices.begin(), data.otherVertices.end(), std::back_inserter(subgraph));
 
-    typedef util::CombinationIterator<VertexSet::const_iterator> CombIt;
+    std::vector<SeparationView> & seeds = workspace.seeds;
+    seeds.clear();
+    cache_->findContainedSeparators(subgraph, seeds);
 
-    std::vector<VertexIndexType> clique;
-    std::merge(oldVertices.begin(), oldVertices.end(), newVertices.begin(), newVertices.end(), std::back_inserter(clique));
+    // below the root the active vertices are old, so the separator needs an other vertex
+    if(!root)
+    {
+        std::vector<SeparationView>::iterator last = seeds.begin();
+        for(std::vector<SeparationView>::const_iterator it = seeds.begin(); it != seeds.end(); ++it)
+            if(!std::includes(data.activeVertices.begin(), data.activeVertices.end(), it->separator().first, it->separator().second))
+                *last++ = *it;
+        seeds.erase(last, seeds.end());
+    }
 
-    UsedSeparatorNodeSet usedSeparators;
+    // a clique is grown from the smallest separator it contains
+    std::sort(seeds.begin(), seeds.end(), SeparatorLess());
 
-    // first loop over all combinations of the new vertices
-    for(CombIt newIt = CombIt(newVertices.begin(), newVertices.end()); newIt != CombIt(); ++newIt)
+    // the positions of the seeds among the other vertices, and the seeds by their lowest position. The
+    // seeds inside the active vertices come last, these are in every clique
+    const VertexSet & otherVertices = data.otherVertices;
+    workspace.seedPositions.resize(seeds.size());
+    workspace.seedsByPosition.resize(otherVertices.size() + 1);
+    for(std::size_t i = 0; i < workspace.seedsByPosition.size(); ++i)
+        workspace.seedsByPosition[i].clear();
+    workspace.chosenPositions.assign(otherVertices.size(), false);
+
+    for(std::size_t seed = 0; seed < seeds.size(); ++seed)
     {
-        // extract the new vertices
-        VertexSet curNew(newIt->begin(), newIt->end());
+        std::vector<std::size_t> & positions = workspace.seedPositions[seed];
+        positions.clear();
 
-        // make sure that there is at least one new vertex (otherwise we should not check for separation)
-        if(curNew.empty())
-            continue;
+        VertexSet::const_iterator otherIt = otherVertices.begin();
+        for(std::pair<SeparationView::VertexIterator, SeparationView::VertexIterator> separator = seeds[seed].separator(); separator.first != separator.second; ++separator.first)
+        {
+            otherIt = std::lower_bound(otherIt, otherVertices.end(), *separator.first);
+            if(otherIt != otherVertices.end() && *otherIt == *separator.first)
+                positions.push_back(otherIt - otherVertices.begin());
+        }
+
+        workspace.seedsByPosition[positions.empty() ? otherVertices.size() : positions.front()].push_back(seed);
+    }
+}
+
+
+void Decomposer::enumerateCliques(const SubgraphNodeData & data, std::size_t count, bool activeAreOld, std::size_t seed, CliqueWorkspace & workspace, std::vector<CliqueCandidate> & cliques) const
+{
+    const VertexSet & activeVertices = data.activeVertices;
+    const VertexSet & otherVertices = data.otherVertices;
+
+    // the positions of the other vertices in the seed, these are always chosen
+    const std::vector<std::size_t> & seedPositions = seed == NoSeed() ? NoPositions : workspace.seedPositions[seed];
+
+    if(seedPositions.size() > count)
+        return;
+
+    // the other positions are chosen from the ones outside the seed, in lexicographical order
+    const std::size_t n = otherVertices.size() - seedPositions.size();
+    const std::size_t free = count - seedPositions.size();
+    if(free > n)
+        return;
+
+    std::vector<std::size_t> & positions = workspace.positions;
+    positions.resize(free);
+    for(std::size_t i = 0; i < free; ++i)
+        positions[i] = i;
+
+    std::vector<std::size_t> & chosen = workspace.chosen;
+    VertexSet & clique = workspace.clique;
+
+    while(true)
+    {
+        // map the free positions past the seed positions, and merge them
+        chosen.clear();
+        std::vector<std::size_t>::const_iterator seedIt = seedPositions.begin();
+        for(std::vector<std::size_t>::const_iterator positionIt = positions.begin(); positionIt != positions.end(); ++positionIt)
+        {
+            std::size_t position = *positionIt + (seedIt - seedPositions.begin());
+            for(; seedIt != seedPositions.end() && *seedIt <= position; ++seedIt, ++position)
+                chosen.push_back(*seedIt);
+            chosen.push_back(position);
+        }
+        chosen.insert(chosen.end(), seedIt, seedPositions.end());
 
-        // now loop over all combinations of the old vertices
-        for(CombIt oldIt = CombIt(oldVertices.begin(), oldVertices.end()); oldIt != CombIt(); ++oldIt)
+        // a clique containing a smaller seed is grown from that one, so it is tried there
+        if(seed == NoSeed() || !containsSmallerSeed(seed, activeVertices.size() + count, workspace))
         {
-            // extract the old vertices
-            VertexSet curOld(oldIt->begin(), oldIt->end());
+            // merge the active vertices with the chosen ones, and mark where the old ones end up
+            clique.clear();
+            CliqueMask oldVertices = 0;
+
+            VertexSet::const_iterator activeIt = activeVertices.begin();
+            std::vector<std::size_t>::const_iterator chosenIt = chosen.begin();
+            while(activeIt != activeVertices.end() || chosenIt != chosen.end())
+            {
+                if(chosenIt == chosen.end() || (activeIt != activeVertices.end() && *activeIt < otherVertices[*chosenIt]))
+                {
+                    if(activeAreOld)
+                        oldVertices |= CliqueMask(1) << clique.size();
+                    clique.push_back(*activeIt++);
+                }
+                else
+                    clique.push_back(otherVertices[*chosenIt++]);
+            }
+
+            tryClique(oldVertices, workspace, cliques);
+        }
+
+        // the last position which can still move to the right
+        std::size_t i = free;
+        while(i > 0 && positions[i - 1] == n - free + i - 1)
+            --i;
+
+        if(i == 0)
+            break;
+
+        ++positions[i - 1];
+        for(; i < free; ++i)
+            positions[i] = positions[i - 1] + 1;
+    }
+}
 
-            // did we select all vertices
-            if(curOld.size() + curNew.size() > curK)
+
+bool Decomposer::containsSmallerSeed(std::size_t seed, std::size_t cliqueSize, CliqueWorkspace & workspace) const
+{
+    const std::vector<std::size_t> & chosen = workspace.chosen;
+    std::vector<bool> & marked = workspace.chosenPositions;
+    for(std::vector<std::size_t>::const_iterator it = chosen.begin(); it != chosen.end(); ++it)
+        marked[*it] = true;
+
+    // a smaller seed inside the clique has its lowest position among the chosen ones, or none at all
+    bool found = false;
+    for(std::size_t i = 0; i <= chosen.size() && !found; ++i)
+    {
+        const std::vector<std::size_t> & candidates = workspace.seedsByPosition[i < chosen.size() ? chosen[i] : marked.size()];
+        for(std::vector<std::size_t>::const_iterator it = candidates.begin(); it != candidates.end() && *it < seed && !found; ++it)
+        {
+            // the separator should be a proper subset of the clique
+            if(workspace.seeds[*it].separatorSize() >= cliqueSize)
                 continue;
 
-            // create the possible separator
-            VertexSet possibleSeparator;
-            std::merge(curNew.begin(), curNew.end(), curOld.begin(), curOld.end(), std::back_inserter(possibleSeparator));
+            const std::vector<std::size_t> & positions = workspace.seedPositions[*it];
+            std::vector<std::size_t>::const_iterator positionIt = positions.begin();
+            while(positionIt != positions.end() && marked[*positionIt])
+                ++positionIt;
+
+            found = positionIt == positions.end();
+        }
+    }
+
+    for(std::vector<std::size_t>::const_iterator it = chosen.begin(); it != chosen.end(); ++it)
+        marked[*it] = false;
+
+    return found;
+}
+
+
+void Decomposer::tryClique(CliqueMask oldVertices, CliqueWorkspace & workspace, std::vector<CliqueCandidate> & cliques) const
+{
+    const VertexSet & clique = workspace.clique;
+    assert(clique.size() <= MaxCliqueSize);
+
+    // all stored separators inside the clique, instead of looking up every subset
+    std::vector<SeparationView> & separations = workspace.containedSeparators;
+    separations.clear();
+    cache_->findContainedSeparators(clique, separations);
+
+    workspace.separators.clear();
 
-            // and now try this separator
-            trySeparator(possibleSeparator, clique, usedSeparators);
+    for(std::vector<SeparationView>::const_iterator it = separations.begin(); it != separations.end(); ++it)
+    {
+        // did we select all vertices
+        if(it->separatorSize() >= clique.size())
+            continue;
+
+        // the positions of the separator in the clique, both are sorted
+        std::pair<SeparationView::VertexIterator, SeparationView::VertexIterator> separator = it->separator();
+        CliqueMask separatorVertices = 0;
+        for(std::size_t position = 0; separator.first != separator.second; ++position)
+        {
+            if(clique[position] == *separator.first)
+            {
+                separatorVertices |= CliqueMask(1) << position;
+                ++separator.first;
+            }
         }
+
+        // make sure that there is at least one new vertex (otherwise we should not check for separation)
+        if((separatorVertices & ~oldVertices) == 0)
+            continue;
+
+        // and now try this separator
+        trySeparator(*it, separatorVertices, workspace);
     }
 
 
     // nothing found
-    if(usedSeparators.empty())
+    if(workspace.separators.empty())
         return;
 
     // did we already try this combination for this subgraph?
-    if(!cache.insert(usedSeparators).second)
+    workspace.key.clear();
+    for(std::vector<SeparatorCandidate>::const_iterator it = workspace.separators.begin(); it != workspace.separators.end(); ++it)
+        workspace.key.push_back(it->data);
+    std::sort(workspace.key.begin(), workspace.key.end());
+    workspace.key.erase(std::unique(workspace.key.begin(), workspace.key.end()), workspace.key.end());
+
+    std::pair<std::map<std::vector<SeparatorNodeData>, std::size_t>::iterator, bool> added = workspace.added.insert(std::make_pair(workspace.key, cliques.size()));
+    if(added.second)
+    {
+        // okay, a new combination so keep it
+        cliques.push_back(CliqueCandidate());
+        cliques.back().clique = clique;
+        cliques.back().separators.swap(workspace.separators);
+        return;
+    }
+
+    // the same separator nodes for the same subgraph, the clique enumerated first is kept
+    if(added.first->second == NoClique())
         return;
 
-    // okay, a new combination so add it
-    dag_.addClique(subgraphNode, clique, usedSeparators.begin(), usedSeparators.end());
+    CliqueCandidate & kept = cliques[added.first->second];
+    if(kept.clique.size() == clique.size() && std::lexicographical_compare(kept.clique.begin(), kept.clique.end(), clique.begin(), clique.end()))
+    {
+        kept.clique = clique;
+        kept.separators.swap(workspace.separators);
+    }
 }
 
 
-void Decomposer::trySeparator(const VertexSet & possibleSeparator, const VertexSet & clique, UsedSeparatorNodeSet & usedSeparators)
+void Decomposer::trySeparator(const SeparationView & separation, CliqueMask separatorVertices, CliqueWorkspace & workspace) const
 {
-    // do we have this separator
-    const Separation * separation = cache_.findSeparator(possibleSeparator);
-    if(separation == 0)
-        return;
+    const VertexSet & clique = workspace.clique;
+    const CliqueMask cliqueVertices = clique.size() == MaxCliqueSize ? ~CliqueMask(0) : (CliqueMask(1) << clique.size()) - 1;
 
-    // extract the non-separator vertices
-    VertexSet nonSeparatorVertices;
-    std::set_difference(clique.begin(), clique.end(), possibleSeparator.begin(), possibleSeparator.end(), std::back_inserter(nonSeparatorVertices));
-    assert(!nonSeparatorVertices.empty());
+    // the components of the non-separator vertices
+    CliqueMask nonSeparatorVertices = cliqueVertices & ~separatorVertices;
+    assert(nonSeparatorVertices != 0);
 
-    // okay, now find the single component have the non-SeparatorVertices
-    std::set<VertexIndexType> inactiveComponents;
-    for(VertexSet::const_iterator it = nonSeparatorVertices.begin(); it != nonSeparatorVertices.end(); ++it)
-        if(separation->componentMap[*it] != separation->UnassignedVertex())
-            inactiveComponents.insert(separation->componentMap[*it]);
+    VertexSet & inactiveComponents = workspace.inactiveComponents;
+    inactiveComponents.clear();
+    for(; nonSeparatorVertices != 0; nonSeparatorVertices &= nonSeparatorVertices - 1)
+    {
+        const VertexIndexType component = separation.componentOf(clique[util::BitsetWordTraits<CliqueMask>::lowest(nonSeparatorVertices)]);
+        if(component != UnassignedVertex())
+            inactiveComponents.push_back(component);
+    }
 
+    std::sort(inactiveComponents.begin(), inactiveComponents.end());
+    inactiveComponents.erase(std::unique(inactiveComponents.begin(), inactiveComponents.end()), inactiveComponents.end());
 
-    // and add this separator
-    usedSeparators.insert(addSeparatorNode(*separation, VertexSet(inactiveComponents.begin(), inactiveComponents.end())));
+    // and remember this separator, the node is created when the clique is added
+    workspace.separators.push_back(SeparatorCandidate());
+    SeparatorCandidate & candidate = workspace.separators.back();
+    candidate.separation = separation;
+    candidate.data.separator.assign(separation.separator().first, separation.separator().second);
+    candidate.data.inactiveComponents = inactiveComponents;
 }
 
 
-DecompositionDAG::NodeDescriptor Decomposer::addSeparatorNode(const Separation & separation, const VertexSet & inactiveIndices)
+void Decomposer::addCliques(DecompositionDAG::NodeDescriptor subgraphNode, const std::vector<CliqueCandidate> & cliques)
 {
-    // create the separator node data
-    SeparatorNodeData sepData;
-    sepData.separator = separation.separator;
-    sepData.inactiveComponents = inactiveIndices;
+    for(std::vector<CliqueCandidate>::const_iterator it = cliques.begin(); it != cliques.end(); ++it)
+    {
+        std::set<DecompositionDAG::NodeDescriptor> usedSeparators;
+        for(std::vector<SeparatorCandidate>::const_iterator sepIt = it->separators.begin(); sepIt != it->separators.end(); ++sepIt)
+            usedSeparators.insert(addSeparatorNode(sepIt->separation, sepIt->data));
+
+        exploredDAG().addClique(subgraphNode, it->clique, usedSeparators.begin(), usedSeparators.end());
+    }
+}
+
+
+DecompositionDAG::NodeDescriptor Decomposer::addSeparatorNode(const SeparationView & separation, const SeparatorNodeData & sepData)
+{
+    const VertexSet & inactiveIndices = sepData.inactiveComponents;
 
     // have we already processed this?
-    DecompositionDAG::NodeDescriptor sepNode = dag_.findSeparatorNode(sepData);
+    DecompositionDAG::NodeDescriptor sepNode = exploredDAG().findSeparatorNode(sepData);
     if(sepNode != DecompositionDAG::InvalidNode())
         return sepNode;
 
@@ -199,10 +749,13 @@ DecompositionDAG::NodeDescriptor Decomposer::addSeparatorNode(const Separation &
 
     VertexSet::const_iterator inactiveIt = inactiveIndices.begin();
 
+    ComponentSet components;
+    separation.components(components);
+
     // loop over all components
-    for(std::size_t i = 0; i < separation.components.size(); ++i)
+    for(std::size_t i = 0; i < components.size(); ++i)
     {
-        assert(inactiveIt == inactiveIndices.end() || *inactiveIt <= i);
+        assert(inactiveIt == inactiveIndices.end() || *inactiveIt >= i);
 
         // is this an inactive index?
         if(inactiveIt != inactiveIndices.end() && *inactiveIt == i)
@@ -212,17 +765,17 @@ DecompositionDAG::NodeDescriptor Decomposer::addSeparatorNode(const Separation &
         }
 
         // no so find or create the subgraph
-        const SubgraphNodeData & nodeData = createSubgraphNodeData(separation.separator, separation.components[i]);
+        const SubgraphNodeData & nodeData = createSubgraphNodeData(sepData.separator, components[i]);
 
         // add to the list of subgraphs
         subgraphs.push_back(nodeData);
 
         // and add the node id also
-        DecompositionDAG::NodeDescriptor nd = dag_.findSubgraphNode(nodeData);
-        if(nd == dag_.InvalidNode())
+        DecompositionDAG::NodeDescriptor nd = exploredDAG().findSubgraphNode(nodeData);
+        if(nd == exploredDAG().InvalidNode())
         {
             // no, so create it
-            nd = dag_.addSubgraph(nodeData);
+            nd = exploredDAG().addSubgraph(nodeData);
 
             // and add it to be processed
             todo_.push(nd);
@@ -232,7 +785,7 @@ DecompositionDAG::NodeDescriptor Decomposer::addSeparatorNode(const Separation &
     }
 
     // and add separator
-    return dag_.addSeparator(sepData, subgraphs.begin(), subgraphs.end());
+    return exploredDAG().addSeparator(sepData, subgraphs.begin(), subgraphs.end());
 }
 
 SubgraphNodeData Decomposer::createSubgraphNodeData(const VertexSet & separator, const VertexSet & component)
@@ -3,6 +3,13 @@
 
 #include "separatorCache.hpp"
 #include "decompositionDAG.hpp"
+#include "vertexOrdering.hpp"
+#include "cancellationToken.hpp"
+#include <boost/atomic.hpp>
+#include <boost/chrono.hpp>
+#include <boost/function.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <map>
 #include <stack>
 
 namespace treeDAG {
@@ -10,40 +17,214 @@ namespace treeDAG {
 class Decomposer : public SeparatorConfig
 {
 public:
+    // how the last process() ended. A run stopped early still cleans up the dag of the nodes explored so
+    // far, the subgraph nodes which were still waiting are in it without cliques
+    enum Status
+    {
+        STATUS_Complete,
+        STATUS_Cancelled,
+        STATUS_TimeBudget,
+        STATUS_NodeBudget,
+        STATUS_MemoryBudget
+    };
+
+    // the limits of a process() run, zero for no limit. The time is counted from the start of process(),
+    // the nodes are those of the uncleaned dag, and the bytes are those of the dag and the cache
+    struct Budget
+    {
+        Budget() : time(boost::chrono::nanoseconds::zero()), nodes(0), bytes(0) {}
+
+        boost::chrono::nanoseconds time;
+        std::size_t nodes;
+        std::size_t bytes;
+    };
+
+    struct Progress
+    {
+        Progress() : queueDepth(0), nodes(0), separatorHits(0), bytes(0), time(boost::chrono::nanoseconds::zero()) {}
+
+        // the subgraph nodes waiting to be processed
+        std::size_t queueDepth;
+        std::size_t nodes;
+        // the separators found in the cache for the cliques added
+        std::size_t separatorHits;
+        // estimated, the dag is only measured again after it grew by an eighth
+        std::size_t bytes;
+        boost::chrono::nanoseconds time;
+    };
+
+    typedef boost::function<void (const Progress &)> ProgressCallback;
+
     Decomposer();
     Decomposer(const Graph * graph, std::size_t k);
+    Decomposer(const CSRGraph * graph, std::size_t k);
+
+    // shares the cache with other decomposers of the same graph, for instance for other roots. The
+    // cache is initialized by its owner, initialize() leaves it as it is. Throws a std::logic_error
+    // when the cache was built for another graph or for a smaller k
+    Decomposer(const CSRGraph * graph, std::size_t k, const boost::shared_ptr<SeparatorCache> & cache);
+
+    // renumbers the graph first, the cache then works on the ordered graph. The roots and the dag
+    // after process() are in the numbering of the input
+    Decomposer(const CSRGraph * graph, std::size_t k, VertexOrdering::OrderingMethod ordering);
+
+
+    // the number of threads finding the cliques of the subgraph nodes, zero for all available cores. The
+    // nodes are added to the dag in the same order for any number of threads, so the dag is always the same
+    void setNumberOfThreads(std::size_t numberOfThreads);
+    std::size_t numberOfThreads() const;
+
+    // initialize() first computes lower bounds on the treewidth. When the best one is above k there is
+    // no decomposition, so the cache is not initialized and process() leaves the dag empty
+    std::size_t lowerBound() const;
+    bool feasible() const;
+
+    // keeps the explored subgraph nodes apart from the cleaned dag, so that after increaseK() the next
+    // process() with the same roots only tries the larger cliques in them, and only explores the new
+    // subgraph nodes. Off by default, since it keeps a second copy of the dag
+    void setIncremental(bool incremental);
+    bool incremental() const;
 
+    // raises k without starting over: the cache keeps its separators and only searches the new sizes.
+    // A shared cache should be raised by its owner, process() throws a std::logic_error until it is.
+    // Throws a std::logic_error when k would decrease
+    void increaseK(std::size_t k);
+    std::size_t k() const;
+
+    // the budget is checked after every batch of subgraph nodes, the time and the cancellation also
+    // between the nodes of a batch
+    void setBudget(const Budget & budget);
+    const Budget & budget() const;
+
+    // the token stays cancelled, so it should be reset before the next process()
+    void setCancellationToken(const CancellationToken & token);
+    CancellationToken cancellationToken() const;
+
+    // called from the thread calling process() after every batch of subgraph nodes
+    void setProgressCallback(const ProgressCallback & callback);
 
     void initialize();
     template <typename VertexIterator> void process(VertexIterator firstRoot, VertexIterator lastRoot);
 
+    Status status() const;
+    const Progress & progress() const;
+
     void writeDot(std::ostream & stream) const;
 
     const DecompositionDAG & decompositionDAG() const { return dag_; }
+    DecompositionDAG & decompositionDAG() { return dag_; }
+    SeparatorCache & separatorCache() { return *cache_; }
 
 
 private:
-    typedef std::set<DecompositionDAG::NodeDescriptor> UsedSeparatorNodeSet;
-
-    void process(DecompositionDAG::NodeDescriptor node);
-    void tryClique(DecompositionDAG::NodeDescriptor subgraphNode, const VertexSet & oldVertices, const VertexSet & newVertices, boost::unordered_set<UsedSeparatorNodeSet> & cache);
-    void trySeparator(const VertexSet & possibleSeparator, const VertexSet & clique, UsedSeparatorNodeSet & usedSeparators);
+    // the subgraph nodes are taken from the todo stack in batches of this size, their cliques are found
+    // in parallel, and then added to the dag in the order of the batch
+    static const std::size_t BatchSize = 1024;
+
+    // the positions of a clique as the bits of a word, so a clique has at most 64 vertices
+    typedef boost::uint64_t CliqueMask;
+    static const std::size_t MaxCliqueSize = 64;
+
+    // the cliques are grown from the seed with this index, or from nothing
+    static std::size_t NoSeed() { return std::numeric_limits<std::size_t>::max(); }
+
+    // the separator nodes used by a clique of an earlier k
+    static std::size_t NoClique() { return std::numeric_limits<std::size_t>::max(); }
+
+    // a clique with the separator nodes it uses, these are only created when the clique is added
+    struct SeparatorCandidate
+    {
+        SeparationView separation;
+        SeparatorNodeData data;
+    };
+
+    struct CliqueCandidate
+    {
+        VertexSet clique;
+        std::vector<SeparatorCandidate> separators;
+    };
+
+    // the scratch space of a thread finding cliques, reused for every clique
+    struct CliqueWorkspace
+    {
+        VertexSet subgraph;
+        std::vector<SeparationView> seeds;
+        std::vector<std::vector<std::size_t> > seedPositions;
+        std::vector<std::vector<std::size_t> > seedsByPosition;
+        std::vector<bool> chosenPositions;
+        std::vector<std::size_t> positions;
+        std::vector<std::size_t> chosen;
+        VertexSet clique;
+        VertexSet inactiveComponents;
+        std::vector<SeparatorCandidate> separators;
+        std::vector<SeparationView> containedSeparators;
+        // the separator nodes of the cliques kept, with the clique which uses them
+        std::map<std::vector<SeparatorNodeData>, std::size_t> added;
+        std::vector<SeparatorNodeData> key;
+    };
+
+    // the dag the subgraph nodes are explored in, which is only the result when not incremental
+    DecompositionDAG & exploredDAG() { return incremental_ && explored_ ? *explored_ : dag_; }
+    const DecompositionDAG & exploredDAG() const { return incremental_ && explored_ ? *explored_ : dag_; }
+
+    // a stop which can happen while finding cliques, and one which is only checked between batches
+    Status interruption() const;
+    Status exhaustion();
+    void checkCache() const;
+    void startRun();
 
     void processRoot();
-
-    DecompositionDAG::NodeDescriptor addSeparatorNode(const Separation & separation, const VertexSet & inactiveIndex);
+    void processExplored();
+    void processBatch(const std::vector<DecompositionDAG::NodeDescriptor> & batch, std::size_t firstCliqueSize);
+    void findCliquesWorker(const std::vector<DecompositionDAG::NodeDescriptor> & batch, std::size_t firstCliqueSize, std::vector<std::vector<CliqueCandidate> > & results, boost::atomic<std::size_t> & next) const;
+
+    void findCliques(DecompositionDAG::NodeDescriptor node, std::size_t firstCliqueSize, CliqueWorkspace & workspace, std::vector<CliqueCandidate> & cliques) const;
+    void findSeeds(const SubgraphNodeData & data, bool root, CliqueWorkspace & workspace) const;
+    void enumerateCliques(const SubgraphNodeData & data, std::size_t count, bool activeAreOld, std::size_t seed, CliqueWorkspace & workspace, std::vector<CliqueCandidate> & cliques) const;
+    static bool enumeratedBefore(const CliqueCandidate & lhs, const CliqueCandidate & rhs);
+    bool containsSmallerSeed(std::size_t seed, std::size_t cliqueSize, CliqueWorkspace & workspace) const;
+    void tryClique(CliqueMask oldVertices, CliqueWorkspace & workspace, std::vector<CliqueCandidate> & cliques) const;
+    void trySeparator(const SeparationView & separation, CliqueMask separatorVertices, CliqueWorkspace & workspace) const;
+    void addCliques(DecompositionDAG::NodeDescriptor subgraphNode, const std::vector<CliqueCandidate> & cliques);
+
+    DecompositionDAG::NodeDescriptor addSeparatorNode(const SeparationView & separation, const SeparatorNodeData & sepData);
     SubgraphNodeData createSubgraphNodeData(const VertexSet & separator, const VertexSet & component);
 
 
 
-    SeparatorCache cache_;
+    boost::shared_ptr<const CSRGraph> ownedGraph_;
+    boost::shared_ptr<const VertexOrdering> ordering_;
+    boost::shared_ptr<SeparatorCache> cache_;
+    bool sharedCache_;
     std::size_t k_;
-    const Graph * graph_;
+    const CSRGraph * graph_;
     VertexSet roots_;
     DecompositionDAG dag_;
 
     boost::unordered_set<DecompositionDAG::NodeDescriptor> processed_;
     std::stack<DecompositionDAG::NodeDescriptor> todo_;
+    std::size_t numberOfThreads_;
+    std::size_t lowerBound_;
+    bool initialized_;
+    bool cacheInitialized_;
+
+    // the uncleaned dag of the incremental mode, explored for roots_ up to exploredK_
+    bool incremental_;
+    boost::scoped_ptr<DecompositionDAG> explored_;
+    DecompositionDAG::NodeDescriptor rootNode_;
+    std::size_t exploredK_;
+
+    Budget budget_;
+    CancellationToken token_;
+    ProgressCallback callback_;
+    Status status_;
+    Progress progress_;
+    boost::chrono::steady_clock::time_point start_;
+
+    // the last measurement of the memory, estimated in between from the number of nodes
+    std::size_t measuredNodes_;
+    std::size_t measuredDAGBytes_;
+    std::size_t measuredCacheBytes_;
 };
 
 } // namespace treeDAG
@@ -2,6 +2,7 @@
 #define TREEDAG_DECOMPOSER_HXX
 
 #include "decomposer.hpp"
+#include <stdexcept>
 
 
 namespace treeDAG {
@@ -9,27 +10,79 @@ namespace treeDAG {
 template <typename VertexIterator>
 void Decomposer::process(VertexIterator firstRoot, VertexIterator lastRoot)
 {
-    // start by setting the roots
-    std::set<VertexIndexType> roots(firstRoot, lastRoot);
+    if(k_ + 1 > MaxCliqueSize)
+        throw std::logic_error("Decomposer: the cliques of k + 1 vertices do not fit in a clique mask");
+    checkCache();
+
+    // start by setting the roots, the dag is worked on in the ordered numbering
+    std::set<VertexIndexType> roots;
+    for(; firstRoot != lastRoot; ++firstRoot)
+        roots.insert(ordering_ ? ordering_->orderedVertex(*firstRoot) : *firstRoot);
+
+    // the incremental mode continues with the nodes explored for the same roots
+    const bool resume = incremental_ && explored_ && rootNode_ != DecompositionDAG::InvalidNode() && roots_ == VertexSet(roots.begin(), roots.end());
     roots_.assign(roots.begin(), roots.end());
 
-    processRoot();
+    startRun();
+    if(!feasible())
+        return;
+
+    // a run which does not resume starts over, the nodes of an earlier run are not processed again
+    todo_ = std::stack<DecompositionDAG::NodeDescriptor>();
+    if(incremental_ && !resume)
+    {
+        explored_.reset(new DecompositionDAG());
+        processed_.clear();
+    }
+    else if(!incremental_)
+    {
+        dag_.clear();
+        processed_.clear();
+    }
+
+    if(resume)
+        processExplored();
+    else
+        processRoot();
 
-    while(!todo_.empty())
+    // take the unprocessed nodes in batches, their cliques are found in parallel
+    std::vector<DecompositionDAG::NodeDescriptor> batch;
+    while(!todo_.empty() && status_ == STATUS_Complete)
     {
-        DecompositionDAG::NodeDescriptor nd = todo_.top();
-        todo_.pop();
+        batch.clear();
+        while(!todo_.empty() && batch.size() < BatchSize)
+        {
+            DecompositionDAG::NodeDescriptor nd = todo_.top();
+            todo_.pop();
 
-        // already processed
-        if(!processed_.insert(nd).second)
-            continue;
+            // already processed
+            if(processed_.insert(nd).second)
+                batch.push_back(nd);
+        }
 
-        assert(dag_.nodeType(nd) == DecompositionDAG::NODE_Subgraph);
+        processBatch(batch, 0);
+    }
 
-        process(nd);
+    // the explored nodes are kept, the dag is cleaned on a copy
+    if(incremental_)
+    {
+        exploredK_ = k_;
+        dag_.assign(*explored_);
+    }
+
+    // a run stopped early is not continued, the next one starts over
+    if(status_ != STATUS_Complete)
+    {
+        todo_ = std::stack<DecompositionDAG::NodeDescriptor>();
+        processed_.clear();
+        explored_.reset();
+        rootNode_ = DecompositionDAG::InvalidNode();
     }
 
     dag_.cleanUp();
+
+    if(ordering_)
+        ordering_->lift(dag_, *cache_);
 }
 
 } // namespace treeDAG
@@ -1,4 +1,6 @@
 #include "decompositionDAG.hpp"
+#include "separatorCache.hpp"
+#include <algorithm>
 #include <boost/graph/topological_sort.hpp>
 #include <iostream>
 #include <stack>
@@ -29,6 +31,39 @@ bool isSubset(const VertexSet & possibleSubset, const VertexSet & possibleSupers
     return subIt == possibleSubset.end();
 }
 
+void relabelVertices(const VertexSet & vertexMap, VertexSet & vertices)
+{
+    for(VertexSet::iterator it = vertices.begin(); it != vertices.end(); ++it)
+        *it = vertexMap[*it];
+
+    std::sort(vertices.begin(), vertices.end());
+}
+
+// the full components of the stored separation, numbered in the order of their lowest vertex after the
+// relabeling. The vertices are visited in their new order until every component has been seen
+void relabelComponents(const SeparatorCache & cache, const VertexSet & newOrder, SeparatorNodeData & data)
+{
+    const SeparationView separation = cache.findSeparator(data.separator);
+    if(!separation)
+        throw std::logic_error("DecompositionDAG: the separator of a separator node is not in the cache");
+
+    const std::size_t numberOfComponents = separation.numberOfComponents();
+    std::vector<std::size_t> newNumber(numberOfComponents, SeparatorConfig::UnassignedVertex());
+    std::size_t numbered = 0;
+
+    for(VertexSet::const_iterator it = newOrder.begin(); it != newOrder.end() && numbered < numberOfComponents; ++it)
+    {
+        const std::size_t c = separation.componentOf(*it);
+        if(c < numberOfComponents && newNumber[c] == SeparatorConfig::UnassignedVertex())
+            newNumber[c] = numbered++;
+    }
+
+    for(VertexSet::iterator it = data.inactiveComponents.begin(); it != data.inactiveComponents.end(); ++it)
+        *it = newNumber[*it];
+
+    std::sort(data.inactiveComponents.begin(), data.inactiveComponents.end());
+}
+
 template <typename Iterator>
 struct IteratorStreamer
 {
@@ -102,6 +137,12 @@ bool operator==(const SubgraphNodeData & lhs, const SubgraphNodeData & rhs)
 }
 
 
+bool operator<(const SeparatorNodeData & lhs, const SeparatorNodeData & rhs)
+{
+    return lhs.separator < rhs.separator || (lhs.separator == rhs.separator && lhs.inactiveComponents < rhs.inactiveComponents);
+}
+
+
 std::ostream & operator<<(std::ostream & str, const SeparatorNodeData & separatorNode)
 {
     str << "S(" << make_streamer(separatorNode.separator, ",") << ")";
@@ -154,6 +195,12 @@ const SubgraphNodeData * DecompositionDAG::subgraphNodeData(NodeDescriptor subgr
     return &(subgraphMap_.left.find(subgraphNode)->second);
 }
 
+const VertexSet * DecompositionDAG::cliqueNodeData(NodeDescriptor cliqueNode) const
+{
+    assert(nodeType(cliqueNode) == NODE_Clique);
+    return &(cliqueMap_.find(cliqueNode)->second);
+}
+
 
 DecompositionDAG::NodeDescriptor DecompositionDAG::addSubgraph(const SubgraphNodeData & subgraphNodeData)
 {
@@ -166,6 +213,106 @@ DecompositionDAG::NodeDescriptor DecompositionDAG::addSubgraph(const SubgraphNod
     return nd;
 }
 
+void DecompositionDAG::clear()
+{
+    dag_.clear();
+    subgraphMap_.clear();
+    separatorMap_.clear();
+    cliqueMap_.clear();
+}
+
+void DecompositionDAG::assign(const DecompositionDAG & other)
+{
+    typedef boost::graph_traits<Structure>::vertex_iterator vit;
+    typedef boost::graph_traits<Structure>::edge_iterator eit;
+
+    clear();
+
+    boost::unordered_map<NodeDescriptor, NodeDescriptor> nodeMap;
+    for(std::pair<vit, vit> p = boost::vertices(other.dag_); p.first != p.second; ++p.first)
+    {
+        NodeDescriptor node = boost::add_vertex(other.nodeType(*p.first), dag_);
+        nodeMap.insert(std::make_pair(*p.first, node));
+
+        switch(other.nodeType(*p.first))
+        {
+        case NODE_Subgraph:
+            subgraphMap_.left.insert(std::make_pair(node, *other.subgraphNodeData(*p.first)));
+            break;
+        case NODE_Separator:
+            separatorMap_.left.insert(std::make_pair(node, *other.separatorNodeData(*p.first)));
+            break;
+        case NODE_Clique:
+            cliqueMap_.insert(std::make_pair(node, other.cliqueMap_.find(*p.first)->second));
+            break;
+        }
+    }
+
+    for(std::pair<eit, eit> p = boost::edges(other.dag_); p.first != p.second; ++p.first)
+        boost::add_edge(nodeMap[boost::source(*p.first, other.dag_)], nodeMap[boost::target(*p.first, other.dag_)], dag_);
+}
+
+std::size_t DecompositionDAG::memoryUsage() const
+{
+    // a node holds the hash set of its out edges and the list of its in edges, the data are hashed both ways
+    std::size_t bytes = boost::num_vertices(dag_) * 8 * sizeof(void *) + boost::num_edges(dag_) * 6 * sizeof(void *);
+
+    for(SubgraphMap::left_const_iterator it = subgraphMap_.left.begin(); it != subgraphMap_.left.end(); ++it)
+        bytes += sizeof(SubgraphNodeData) + 4 * sizeof(void *) + (it->second.activeVertices.capacity() + it->second.otherVertices.capacity()) * sizeof(VertexIndexType);
+
+    for(SeparatorMap::left_const_iterator it = separatorMap_.left.begin(); it != separatorMap_.left.end(); ++it)
+        bytes += sizeof(SeparatorNodeData) + 4 * sizeof(void *) + (it->second.separator.capacity() + it->second.inactiveComponents.capacity()) * sizeof(VertexIndexType);
+
+    for(CliqueSizeMap::const_iterator it = cliqueMap_.begin(); it != cliqueMap_.end(); ++it)
+        bytes += sizeof(VertexSet) + 2 * sizeof(void *) + it->second.capacity() * sizeof(VertexIndexType);
+
+    return bytes;
+}
+
+void DecompositionDAG::relabel(const VertexSet & vertexMap, const SeparatorCache * cache)
+{
+    // the data are the keys of the maps, so these are built again
+    SubgraphMap subgraphs;
+    for(SubgraphMap::left_const_iterator it = subgraphMap_.left.begin(); it != subgraphMap_.left.end(); ++it)
+    {
+        SubgraphNodeData data = it->second;
+        relabelVertices(vertexMap, data.activeVertices);
+        relabelVertices(vertexMap, data.otherVertices);
+        subgraphs.left.insert(std::make_pair(it->first, data));
+    }
+
+    // the inactive components are numbers of components, not vertices. The current vertices in their new order
+    VertexSet newOrder;
+    if(cache)
+    {
+        std::vector<std::pair<VertexIndexType, VertexIndexType> > order;
+        order.reserve(vertexMap.size());
+        for(VertexIndexType v = 0; v < vertexMap.size(); ++v)
+            order.push_back(std::make_pair(vertexMap[v], v));
+        std::sort(order.begin(), order.end());
+
+        newOrder.reserve(order.size());
+        for(std::size_t i = 0; i < order.size(); ++i)
+            newOrder.push_back(order[i].second);
+    }
+
+    SeparatorMap separators;
+    for(SeparatorMap::left_const_iterator it = separatorMap_.left.begin(); it != separatorMap_.left.end(); ++it)
+    {
+        SeparatorNodeData data = it->second;
+        if(cache && !data.inactiveComponents.empty())
+            relabelComponents(*cache, newOrder, data);
+        relabelVertices(vertexMap, data.separator);
+        separators.left.insert(std::make_pair(it->first, data));
+    }
+
+    for(CliqueSizeMap::iterator it = cliqueMap_.begin(); it != cliqueMap_.end(); ++it)
+        relabelVertices(vertexMap, it->second);
+
+    subgraphMap_ = subgraphs;
+    separatorMap_ = separators;
+}
+
 void DecompositionDAGNodeStreamWriter::toStream(std::ostream & stream) const
 {
     if(dag_ == 0)
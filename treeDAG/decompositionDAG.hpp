@@ -3,6 +3,7 @@
 
 #include "separatorConfig.hpp"
 #include "separation.hpp"
+#include "csrGraph.hpp"
 
 #include <boost/graph/adjacency_list.hpp>
 #include <boost/unordered_map.hpp>
@@ -32,11 +33,13 @@ std::size_t hash_value(const SubgraphNodeData & subgraphNode);
 
 bool operator==(const SeparatorNodeData & lhs, const SeparatorNodeData & rhs);
 bool operator==(const SubgraphNodeData & lhs, const SubgraphNodeData & rhs);
+bool operator<(const SeparatorNodeData & lhs, const SeparatorNodeData & rhs);
 
 std::ostream & operator<<(std::ostream & str, const SeparatorNodeData & separatorNode);
 std::ostream & operator<<(std::ostream & str, const SubgraphNodeData & separatorNode);
 
 struct DecompositionDAGNodeStreamWriter;
+class SeparatorCache;
 
 class DecompositionDAG : public boost::noncopyable, public SeparatorConfig
 {
@@ -65,6 +68,7 @@ public:
     NodeDescriptor findSubgraphNode(const SubgraphNodeData & subgraphNodeData) const;
     const SeparatorNodeData * separatorNodeData(NodeDescriptor separatorNode) const;
     const SubgraphNodeData * subgraphNodeData(NodeDescriptor subgraphNode) const;
+    const VertexSet * cliqueNodeData(NodeDescriptor cliqueNode) const;
 
     // addition methods
     template <typename SubgraphNodeDataIterator>
@@ -76,9 +80,23 @@ public:
 
     void cleanUp();
 
+    void clear();
+
+    // replaces the nodes by a copy of the nodes of the other dag, in the same order
+    void assign(const DecompositionDAG & other);
+
+    // renumbers the vertices in all nodes, vertex v becomes vertexMap[v]. The inactive components of
+    // the separator nodes are numbered in the order of their lowest vertex, which a map that is not
+    // increasing changes: then they are numbered again through the separations stored in the cache,
+    // which is in the current numbering and should hold the separators of the nodes
+    void relabel(const VertexSet & vertexMap, const SeparatorCache * cache = 0);
+
     std::size_t numberOfNodes() const { return boost::num_vertices(dag_); }
     std::size_t numberOfBranches() const { return boost::num_edges(dag_); }
 
+    // the approximate number of bytes used by the nodes, the branches and the node data
+    std::size_t memoryUsage() const;
+
     DecompositionDAGNodeStreamWriter nodeWriter(NodeDescriptor node) const;
 
 
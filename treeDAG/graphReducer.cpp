@@ -0,0 +1,288 @@
+#include "graphReducer.hpp"
+#include <algorithm>
+#include <deque>
+
+namespace treeDAG {
+namespace {
+
+typedef SeparatorConfig::VertexIndexType VertexIndexType;
+
+void enqueue(VertexIndexType vertex, std::deque<VertexIndexType> & queue, std::vector<bool> & queued)
+{
+    if(queued[vertex])
+        return;
+
+    queued[vertex] = true;
+    queue.push_back(vertex);
+}
+
+} // namespace
+
+
+GraphReducer::GraphReducer(const CSRGraph * graph)
+    : graph_(graph),
+      lowerBound_(0)
+{
+}
+
+
+void GraphReducer::reduce()
+{
+    reduce(std::vector<bool>(graph_->numVertices(), false));
+}
+
+
+void GraphReducer::reduce(const std::vector<bool> & roots)
+{
+    typedef CSRGraph::AdjacencyIterator adjIt;
+    typedef std::set<VertexIndexType>::const_iterator setIt;
+
+    const std::size_t graphSize = graph_->numVertices();
+
+    adjacency_.assign(graphSize, std::set<VertexIndexType>());
+    for(VertexIndexType v = 0; v < graphSize; ++v)
+        for(std::pair<adjIt, adjIt> p = graph_->adjacentVertices(v); p.first != p.second; ++p.first)
+            if(*p.first != v)
+                adjacency_[v].insert(*p.first);
+
+    reductions_.clear();
+    lowerBound_ = minimumDegreeLowerBound();
+
+    std::vector<bool> removed(graphSize, false);
+    std::vector<bool> queued(graphSize, false);
+    std::deque<VertexIndexType> queue;
+    for(VertexIndexType v = 0; v < graphSize; ++v)
+        enqueue(v, queue, queued);
+
+    // the almost simplicial vertices of a degree above the lower bound, until the bound grows
+    VertexSet deferred;
+
+    while(!queue.empty())
+    {
+        VertexIndexType v = queue.front();
+        queue.pop_front();
+        queued[v] = false;
+
+        if(removed[v] || roots[v])
+            continue;
+
+        ReductionRule rule;
+        VertexIndexType apex;
+        if(!findRule(v, rule, apex))
+            continue;
+
+        if(apex != UnassignedVertex() && adjacency_[v].size() > lowerBound_)
+        {
+            deferred.push_back(v);
+            continue;
+        }
+
+        const std::size_t previousBound = lowerBound_;
+        const std::set<VertexIndexType> neighbours = adjacency_[v];
+
+        eliminate(v, rule, apex);
+        removed[v] = true;
+
+        // the neighbourhoods which changed are those of the neighbours and the vertices next to them
+        for(setIt it = neighbours.begin(); it != neighbours.end(); ++it)
+        {
+            enqueue(*it, queue, queued);
+            for(setIt jt = adjacency_[*it].begin(); jt != adjacency_[*it].end(); ++jt)
+                enqueue(*jt, queue, queued);
+        }
+
+        if(lowerBound_ > previousBound)
+        {
+            for(VertexSet::const_iterator it = deferred.begin(); it != deferred.end(); ++it)
+                if(!removed[*it])
+                    enqueue(*it, queue, queued);
+            deferred.clear();
+        }
+    }
+
+    // number the remaining vertices in their original order
+    originalVertices_.clear();
+    reducedVertices_.assign(graphSize, UnassignedVertex());
+    for(VertexIndexType v = 0; v < graphSize; ++v)
+        if(!removed[v])
+        {
+            reducedVertices_[v] = originalVertices_.size();
+            originalVertices_.push_back(v);
+        }
+
+    std::vector<std::pair<VertexIndexType, VertexIndexType> > edges;
+    for(VertexSet::const_iterator it = originalVertices_.begin(); it != originalVertices_.end(); ++it)
+        for(setIt jt = adjacency_[*it].upper_bound(*it); jt != adjacency_[*it].end(); ++jt)
+            edges.push_back(std::make_pair(reducedVertices_[*it], reducedVertices_[*jt]));
+
+    reduced_ = CSRGraph::fromEdges(originalVertices_.size(), edges.begin(), edges.end());
+    std::vector<std::set<VertexIndexType> >().swap(adjacency_);
+
+    // the neighbours of a reduction are a clique until the first of them is removed, so they are in
+    // the bag of that reduction
+    std::vector<std::size_t> reductionOf(graphSize, NoReduction());
+    for(std::size_t i = 0; i < reductions_.size(); ++i)
+        reductionOf[reductions_[i].vertex] = i;
+
+    for(std::vector<Reduction>::iterator it = reductions_.begin(); it != reductions_.end(); ++it)
+    {
+        it->parent = NoReduction();
+        for(VertexSet::const_iterator jt = it->neighbours.begin(); jt != it->neighbours.end(); ++jt)
+            it->parent = std::min(it->parent, reductionOf[*jt]);
+    }
+}
+
+
+void GraphReducer::renumber(DecompositionDAG & dag) const
+{
+    dag.relabel(originalVertices_);
+}
+
+
+void GraphReducer::bag(std::size_t reduction, VertexSet & bag) const
+{
+    const Reduction & r = reductions_[reduction];
+    bag = r.neighbours;
+    bag.insert(std::lower_bound(bag.begin(), bag.end(), r.vertex), r.vertex);
+}
+
+
+void GraphReducer::parentBags(std::size_t reduction, const DecompositionDAG & dag, std::vector<DecompositionDAG::NodeDescriptor> & bags) const
+{
+    typedef boost::graph_traits<DecompositionDAG::Structure>::vertex_iterator NodeIterator;
+
+    bags.clear();
+    if(reductions_[reduction].parent != NoReduction())
+        return;
+
+    const VertexSet & neighbours = reductions_[reduction].neighbours;
+    for(std::pair<NodeIterator, NodeIterator> p = boost::vertices(dag.structure()); p.first != p.second; ++p.first)
+    {
+        if(dag.nodeType(*p.first) != DecompositionDAG::NODE_Clique)
+            continue;
+
+        const VertexSet & clique = *dag.cliqueNodeData(*p.first);
+        if(std::includes(clique.begin(), clique.end(), neighbours.begin(), neighbours.end()))
+            bags.push_back(*p.first);
+    }
+}
+
+
+std::size_t GraphReducer::minimumDegreeLowerBound() const
+{
+    typedef std::set<VertexIndexType>::const_iterator setIt;
+
+    // the largest minimum degree while removing a vertex of minimum degree every time
+    const std::size_t graphSize = adjacency_.size();
+    std::vector<std::size_t> degrees(graphSize);
+    std::set<std::pair<std::size_t, VertexIndexType> > order;
+    for(VertexIndexType v = 0; v < graphSize; ++v)
+    {
+        degrees[v] = adjacency_[v].size();
+        order.insert(std::make_pair(degrees[v], v));
+    }
+
+    std::vector<bool> removed(graphSize, false);
+    std::size_t bound = 0;
+    while(!order.empty())
+    {
+        const VertexIndexType v = order.begin()->second;
+        bound = std::max(bound, order.begin()->first);
+        order.erase(order.begin());
+        removed[v] = true;
+
+        for(setIt it = adjacency_[v].begin(); it != adjacency_[v].end(); ++it)
+            if(!removed[*it])
+            {
+                order.erase(std::make_pair(degrees[*it], *it));
+                order.insert(std::make_pair(--degrees[*it], *it));
+            }
+    }
+
+    return bound;
+}
+
+
+bool GraphReducer::findRule(VertexIndexType vertex, ReductionRule & rule, VertexIndexType & apex) const
+{
+    typedef std::set<VertexIndexType>::const_iterator setIt;
+
+    const std::set<VertexIndexType> & neighbours = adjacency_[vertex];
+    const std::size_t degree = neighbours.size();
+    apex = UnassignedVertex();
+
+    if(degree <= 1)
+    {
+        rule = degree == 0 ? RULE_Islet : RULE_Twig;
+        return true;
+    }
+
+    // the pairs of neighbours which are not adjacent, one vertex is in at most degree - 1 of them
+    std::vector<std::pair<VertexIndexType, VertexIndexType> > missing;
+    for(setIt it = neighbours.begin(); it != neighbours.end() && missing.size() < degree; ++it)
+        for(setIt jt = neighbours.upper_bound(*it); jt != neighbours.end() && missing.size() < degree; ++jt)
+            if(adjacency_[*it].count(*jt) == 0)
+                missing.push_back(std::make_pair(*it, *jt));
+
+    if(missing.empty())
+    {
+        rule = RULE_Simplicial;
+        return true;
+    }
+
+    if(missing.size() >= degree)
+        return false;
+
+    // the apex is in all of the missing pairs, so it is in the first one
+    const VertexIndexType candidates[2] = { missing.front().first, missing.front().second };
+    for(std::size_t i = 0; i < 2; ++i)
+    {
+        std::size_t covered = 0;
+        while(covered < missing.size() && (missing[covered].first == candidates[i] || missing[covered].second == candidates[i]))
+            ++covered;
+
+        if(covered == missing.size())
+        {
+            apex = candidates[i];
+            rule = degree == 2 ? RULE_Series : RULE_AlmostSimplicial;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+void GraphReducer::eliminate(VertexIndexType vertex, ReductionRule rule, VertexIndexType apex)
+{
+    typedef std::set<VertexIndexType>::const_iterator setIt;
+
+    std::set<VertexIndexType> & neighbours = adjacency_[vertex];
+
+    Reduction reduction;
+    reduction.rule = rule;
+    reduction.vertex = vertex;
+    reduction.neighbours.assign(neighbours.begin(), neighbours.end());
+
+    // a simplicial vertex and its neighbours are a bag of every tree decomposition
+    if(rule == RULE_Twig || rule == RULE_Simplicial)
+        lowerBound_ = std::max(lowerBound_, neighbours.size());
+
+    // the neighbours become a clique
+    if(apex != UnassignedVertex())
+        for(setIt it = neighbours.begin(); it != neighbours.end(); ++it)
+            if(*it != apex)
+            {
+                adjacency_[apex].insert(*it);
+                adjacency_[*it].insert(apex);
+            }
+
+    for(setIt it = neighbours.begin(); it != neighbours.end(); ++it)
+        adjacency_[*it].erase(vertex);
+    neighbours.clear();
+
+    reduction.lowerBound = lowerBound_;
+    reductions_.push_back(reduction);
+}
+
+} // namespace treeDAG
@@ -0,0 +1,95 @@
+#ifndef TREEDAG_GRAPHREDUCER_HPP
+#define TREEDAG_GRAPHREDUCER_HPP
+
+#include "separatorConfig.hpp"
+#include "csrGraph.hpp"
+#include "decompositionDAG.hpp"
+#include <limits>
+#include <set>
+
+namespace treeDAG {
+
+// shrinks a graph with the safe treewidth reduction rules before it is decomposed: islets, twigs
+// and simplicial vertices are removed, and an almost simplicial vertex (all neighbours but one
+// form a clique) is eliminated when its degree is at most the lower bound, which for degree two
+// contracts series chains. The treewidth of the reduced graph together with the lower bound
+// gives the treewidth of the input. A tree decomposition of the reduced graph extends to the
+// input by going over the reductions in reverse order: the bag of the vertex and its neighbours
+// hangs below a bag containing the neighbours, which is a clique of the reduced graph
+class GraphReducer : public SeparatorConfig
+{
+public:
+    enum ReductionRule
+    {
+        RULE_Islet,
+        RULE_Twig,
+        RULE_Series,
+        RULE_Simplicial,
+        RULE_AlmostSimplicial
+    };
+
+    // an eliminated vertex, with its neighbours at that moment in the original numbering, and
+    // the lower bound after the rule was applied. Its bag is the vertex and the neighbours, which
+    // hangs below the bag of the parent reduction: the first later one removing a neighbour. When
+    // all neighbours stay there is no parent, and the bag hangs below a bag of the reduced graph
+    struct Reduction
+    {
+        ReductionRule rule;
+        VertexIndexType vertex;
+        VertexSet neighbours;
+        std::size_t lowerBound;
+        std::size_t parent;
+    };
+
+    static std::size_t NoReduction() { return std::numeric_limits<std::size_t>::max(); }
+
+    explicit GraphReducer(const CSRGraph * graph = 0);
+
+    // applies the rules until none of them applies anymore, the roots are never removed
+    void reduce();
+    template <typename VertexIterator> void reduce(VertexIterator firstRoot, VertexIterator lastRoot);
+
+    const CSRGraph & reducedGraph() const { return reduced_; }
+    const std::vector<Reduction> & reductions() const { return reductions_; }
+
+    // a lower bound on the treewidth of the input, from the minimum degrees and the rules applied
+    std::size_t lowerBound() const { return lowerBound_; }
+
+    // the vertex numbers between the two graphs, the remaining vertices keep their order. A removed
+    // vertex has no reduced vertex, which is UnassignedVertex()
+    VertexIndexType originalVertex(VertexIndexType reducedVertex) const { return originalVertices_[reducedVertex]; }
+    VertexIndexType reducedVertex(VertexIndexType originalVertex) const { return reducedVertices_[originalVertex]; }
+
+    // renumbers a decomposition dag of the reduced graph to the vertices of the input. The removed
+    // vertices are not added back, the dag stays one of the reduced graph and the bags of the
+    // reductions hang below it. The numbering keeps the order, so the inactive components keep theirs
+    void renumber(DecompositionDAG & dag) const;
+
+    // the bag of a reduction, and the clique nodes of a renumbered dag of the reduced graph containing
+    // the neighbours of a reduction without a parent, its bag is joined to one of them. Together with
+    // the parents of the reductions this lifts a decomposition of the reduced graph to the input
+    void bag(std::size_t reduction, VertexSet & bag) const;
+    void parentBags(std::size_t reduction, const DecompositionDAG & dag, std::vector<DecompositionDAG::NodeDescriptor> & bags) const;
+
+private:
+    void reduce(const std::vector<bool> & roots);
+    std::size_t minimumDegreeLowerBound() const;
+    bool findRule(VertexIndexType vertex, ReductionRule & rule, VertexIndexType & apex) const;
+    void eliminate(VertexIndexType vertex, ReductionRule rule, VertexIndexType apex);
+
+    const CSRGraph * graph_;
+    CSRGraph reduced_;
+    std::vector<Reduction> reductions_;
+    std::size_t lowerBound_;
+    VertexSet originalVertices_;
+    VertexSet reducedVertices_;
+
+    // the working graph while reducing
+    std::vector<std::set<VertexIndexType> > adjacency_;
+};
+
+} // namespace treeDAG
+
+#include "graphReducer.hxx"
+
+#endif // TREEDAG_GRAPHREDUCER_HPP
@@ -0,0 +1,20 @@
+#ifndef TREEDAG_GRAPHREDUCER_HXX
+#define TREEDAG_GRAPHREDUCER_HXX
+
+#include "graphReducer.hpp"
+
+namespace treeDAG {
+
+template <typename VertexIterator>
+void GraphReducer::reduce(VertexIterator firstRoot, VertexIterator lastRoot)
+{
+    std::vector<bool> roots(graph_->numVertices(), false);
+    for(; firstRoot != lastRoot; ++firstRoot)
+        roots[*firstRoot] = true;
+
+    reduce(roots);
+}
+
+} // namespace treeDAG
+
+#endif // TREEDAG_GRAPHREDUCER_HXX
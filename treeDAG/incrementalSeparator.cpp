@@ -0,0 +1,339 @@
+#include "incrementalSeparator.hpp"
+#include <algorithm>
+#include <cassert>
+
+namespace treeDAG {
+
+
+IncrementalSeparator::IncrementalSeparator(const CSRGraph * graph)
+    : graph_(graph),
+      labels_(graph->numVertices(), UnassignedVertex()),
+      sizes_(graph->numVertices(), 0),
+      nextLabel_(0),
+      exploredVertices_(0),
+      owners_(graph->numVertices(), 0),
+      labelStamps_(graph->numVertices(), 0),
+      labelCounts_(graph->numVertices(), 0),
+      labelEpoch_(0)
+{
+}
+
+
+void IncrementalSeparator::reset(const VertexSet & separator)
+{
+    const std::size_t graphSize = graph_->numVertices();
+
+    separator_ = separator;
+    freeLabels_.clear();
+    nextLabel_ = 0;
+
+    workspace_.nextEpoch(graphSize);
+    for(VertexSet::const_iterator it = separator_.begin(); it != separator_.end(); ++it)
+    {
+        workspace_.visit(*it);
+        labels_[*it] = SeparatorVertex();
+    }
+
+    for(VertexIndexType v = 0; v < graphSize; ++v)
+        if(!workspace_.visited(v))
+            fillComponent(v, newLabel());
+}
+
+
+void IncrementalSeparator::exchange(VertexIndexType removed, VertexIndexType added)
+{
+    assert(labels_[removed] == SeparatorVertex() && labels_[added] != SeparatorVertex());
+
+    // update the separator, it stays sorted
+    separator_.erase(std::lower_bound(separator_.begin(), separator_.end(), removed));
+    separator_.insert(std::lower_bound(separator_.begin(), separator_.end(), added), added);
+
+    // first put removed back, and only then take added out
+    merge(removed);
+    split(added);
+}
+
+
+void IncrementalSeparator::merge(VertexIndexType vertex)
+{
+    typedef CSRGraph::AdjacencyIterator adjIt;
+
+    // the largest adjacent component keeps its label
+    VertexIndexType largest = UnassignedVertex();
+    for(std::pair<adjIt, adjIt> p = graph_->adjacentVertices(vertex); p.first != p.second; ++p.first)
+    {
+        VertexIndexType label = labels_[*p.first];
+        if(label != SeparatorVertex() && (largest == UnassignedVertex() || sizes_[label] > sizes_[largest]))
+            largest = label;
+    }
+
+    if(largest == UnassignedVertex())
+        largest = newLabel();
+
+    labels_[vertex] = largest;
+    ++sizes_[largest];
+
+    // and all the others are relabeled
+    for(std::pair<adjIt, adjIt> p = graph_->adjacentVertices(vertex); p.first != p.second; ++p.first)
+    {
+        VertexIndexType label = labels_[*p.first];
+        if(label == SeparatorVertex() || label == largest)
+            continue;
+
+        sizes_[largest] += sizes_[label];
+        relabel(*p.first, label, largest);
+        freeLabel(label);
+    }
+}
+
+
+void IncrementalSeparator::split(VertexIndexType vertex)
+{
+    typedef CSRGraph::AdjacencyIterator adjIt;
+
+    const VertexIndexType label = labels_[vertex];
+    labels_[vertex] = SeparatorVertex();
+    --sizes_[label];
+
+    workspace_.nextEpoch(graph_->numVertices());
+    workspace_.visit(vertex);
+
+    // start a search from every neighbour in the component
+    std::size_t numberOfSearches = 0;
+    for(std::pair<adjIt, adjIt> p = graph_->adjacentVertices(vertex); p.first != p.second; ++p.first)
+    {
+        if(labels_[*p.first] == SeparatorVertex() || workspace_.visited(*p.first))
+            continue;
+
+        if(searches_.size() == numberOfSearches)
+            searches_.push_back(Search());
+
+        Search & search = searches_[numberOfSearches];
+        search.stack.assign(1, *p.first);
+        search.reached.assign(1, *p.first);
+        search.group = numberOfSearches;
+
+        workspace_.visit(*p.first);
+        owners_[*p.first] = numberOfSearches;
+        ++numberOfSearches;
+    }
+
+    if(numberOfSearches == 0)
+        freeLabel(label);
+
+    // a single neighbour, then the rest of the component stays connected
+    if(numberOfSearches <= 1)
+        return;
+
+    // searches which meet are in the same part, expand them one vertex per round until at most one part is unfinished
+    std::vector<bool> unfinished(numberOfSearches);
+    while(true)
+    {
+        std::fill(unfinished.begin(), unfinished.end(), false);
+        std::size_t numberOfUnfinished = 0;
+
+        for(std::size_t i = 0; i < numberOfSearches; ++i)
+        {
+            Search & search = searches_[i];
+            if(search.stack.empty())
+                continue;
+
+            VertexIndexType current = search.stack.back();
+            search.stack.pop_back();
+            ++exploredVertices_;
+
+            for(std::pair<adjIt, adjIt> p = graph_->adjacentVertices(current); p.first != p.second; ++p.first)
+            {
+                if(labels_[*p.first] == SeparatorVertex())
+                    continue;
+
+                if(!workspace_.visited(*p.first))
+                {
+                    workspace_.visit(*p.first);
+                    owners_[*p.first] = i;
+                    search.stack.push_back(*p.first);
+                    search.reached.push_back(*p.first);
+                }
+                else
+                    searches_[findGroup(owners_[*p.first])].group = findGroup(i);
+            }
+        }
+
+        for(std::size_t i = 0; i < numberOfSearches; ++i)
+            if(!searches_[i].stack.empty() && !unfinished[findGroup(i)])
+            {
+                unfinished[findGroup(i)] = true;
+                ++numberOfUnfinished;
+            }
+
+        if(numberOfUnfinished <= 1)
+            break;
+    }
+
+    // the part which is unfinished keeps the label, or the largest part if all of them are finished
+    std::vector<std::size_t> partSizes(numberOfSearches, 0);
+    for(std::size_t i = 0; i < numberOfSearches; ++i)
+        partSizes[findGroup(i)] += searches_[i].reached.size();
+
+    std::size_t keep = UnassignedVertex();
+    for(std::size_t i = 0; i < numberOfSearches; ++i)
+        if(findGroup(i) == i && (unfinished[i] || keep == UnassignedVertex() || (!unfinished[keep] && partSizes[i] > partSizes[keep])))
+            keep = i;
+
+    // all other parts get a new label
+    std::vector<VertexIndexType> partLabels(numberOfSearches, label);
+    for(std::size_t i = 0; i < numberOfSearches; ++i)
+        if(findGroup(i) == i && i != keep)
+        {
+            partLabels[i] = newLabel();
+            sizes_[partLabels[i]] = partSizes[i];
+            sizes_[label] -= partSizes[i];
+        }
+
+    for(std::size_t i = 0; i < numberOfSearches; ++i)
+    {
+        VertexIndexType partLabel = partLabels[findGroup(i)];
+        if(partLabel == label)
+            continue;
+
+        for(VertexSet::const_iterator it = searches_[i].reached.begin(); it != searches_[i].reached.end(); ++it)
+            labels_[*it] = partLabel;
+    }
+}
+
+
+std::size_t IncrementalSeparator::findGroup(std::size_t search)
+{
+    while(searches_[search].group != search)
+    {
+        searches_[search].group = searches_[searches_[search].group].group;
+        search = searches_[search].group;
+    }
+
+    return search;
+}
+
+
+void IncrementalSeparator::relabel(VertexIndexType source, VertexIndexType from, VertexIndexType to)
+{
+    typedef CSRGraph::AdjacencyIterator adjIt;
+
+    // the new label marks the vertices as visited
+    std::vector<VertexIndexType> & stack = workspace_.stack;
+    stack.assign(1, source);
+    labels_[source] = to;
+
+    while(!stack.empty())
+    {
+        VertexIndexType current = stack.back();
+        stack.pop_back();
+        ++exploredVertices_;
+
+        for(std::pair<adjIt, adjIt> p = graph_->adjacentVertices(current); p.first != p.second; ++p.first)
+            if(labels_[*p.first] == from)
+            {
+                labels_[*p.first] = to;
+                stack.push_back(*p.first);
+            }
+    }
+}
+
+
+std::size_t IncrementalSeparator::numberOfFullComponents() const
+{
+    typedef CSRGraph::AdjacencyIterator adjIt;
+
+    if(++labelEpoch_ == 0)
+    {
+        std::fill(labelStamps_.begin(), labelStamps_.end(), 0);
+        labelEpoch_ = 1;
+    }
+
+    // a component is full iff it is adjacent to all separator vertices, so count per label
+    // the number of separator vertices seen so far, only increasing it once per separator vertex
+    std::size_t fullComponents = 0;
+    for(std::size_t i = 0; i < separator_.size(); ++i)
+    {
+        bool anyCandidate = false;
+
+        for(std::pair<adjIt, adjIt> p = graph_->adjacentVertices(separator_[i]); p.first != p.second; ++p.first)
+        {
+            VertexIndexType label = labels_[*p.first];
+            if(label == SeparatorVertex())
+                continue;
+
+            if(labelStamps_[label] != labelEpoch_)
+            {
+                labelStamps_[label] = labelEpoch_;
+                labelCounts_[label] = 0;
+            }
+
+            if(labelCounts_[label] == i)
+            {
+                labelCounts_[label] = i + 1;
+                anyCandidate = true;
+
+                if(i + 1 == separator_.size())
+                    ++fullComponents;
+            }
+        }
+
+        // no component is adjacent to all the separator vertices up to now
+        if(!anyCandidate)
+            return 0;
+    }
+
+    return fullComponents;
+}
+
+
+IncrementalSeparator::VertexIndexType IncrementalSeparator::newLabel()
+{
+    VertexIndexType label;
+    if(freeLabels_.empty())
+        label = nextLabel_++;
+    else
+    {
+        label = freeLabels_.back();
+        freeLabels_.pop_back();
+    }
+
+    sizes_[label] = 0;
+    return label;
+}
+
+
+void IncrementalSeparator::freeLabel(VertexIndexType label)
+{
+    freeLabels_.push_back(label);
+}
+
+
+void IncrementalSeparator::fillComponent(VertexIndexType source, VertexIndexType label)
+{
+    typedef CSRGraph::AdjacencyIterator adjIt;
+
+    std::vector<VertexIndexType> & stack = workspace_.stack;
+    stack.assign(1, source);
+    workspace_.visit(source);
+
+    while(!stack.empty())
+    {
+        VertexIndexType current = stack.back();
+        stack.pop_back();
+
+        labels_[current] = label;
+        ++sizes_[label];
+        ++exploredVertices_;
+
+        for(std::pair<adjIt, adjIt> p = graph_->adjacentVertices(current); p.first != p.second; ++p.first)
+            if(!workspace_.visited(*p.first))
+            {
+                workspace_.visit(*p.first);
+                stack.push_back(*p.first);
+            }
+    }
+}
+
+
+} // namespace treeDAG
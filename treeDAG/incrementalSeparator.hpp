@@ -0,0 +1,77 @@
+#ifndef TREEDAG_INCREMENTALSEPARATOR_HPP
+#define TREEDAG_INCREMENTALSEPARATOR_HPP
+
+#include "separatorConfig.hpp"
+#include "separator.hpp"
+#include "csrGraph.hpp"
+
+namespace treeDAG {
+
+// keeps the components of G - S up to date while S changes one vertex at a time, following a
+// revolving door enumeration of the candidate separators. A vertex leaving S merges the smaller
+// adjacent components into the largest one, a vertex entering S splits its component by searching
+// from all its neighbours at once until only one part is left, so the largest part is never explored
+class IncrementalSeparator : public SeparatorConfig
+{
+public:
+    explicit IncrementalSeparator(const CSRGraph * graph);
+
+    // separates the graph from scratch, the separator should be sorted
+    void reset(const VertexSet & separator);
+
+    // puts removed back into the graph and takes added out of it
+    void exchange(VertexIndexType removed, VertexIndexType added);
+
+    const VertexSet & separator() const { return separator_; }
+
+    // the component label of a vertex, labels are not consecutive. SeparatorVertex() for the separator
+    VertexIndexType componentOf(VertexIndexType vertex) const { return labels_[vertex]; }
+
+    // the number of components whose neighbourhood is the complete separator
+    std::size_t numberOfFullComponents() const;
+
+    // the separator is minimal iff it has at least two full components
+    bool isMinimalSeparator() const { return numberOfFullComponents() > 1; }
+
+    // the number of vertices explored since the construction
+    std::size_t exploredVertices() const { return exploredVertices_; }
+
+private:
+    struct Search
+    {
+        VertexSet stack;
+        VertexSet reached;
+        std::size_t group;
+    };
+
+    void merge(VertexIndexType vertex);
+    void split(VertexIndexType vertex);
+    std::size_t findGroup(std::size_t search);
+    void relabel(VertexIndexType source, VertexIndexType from, VertexIndexType to);
+
+    VertexIndexType newLabel();
+    void freeLabel(VertexIndexType label);
+    void fillComponent(VertexIndexType source, VertexIndexType label);
+
+    const CSRGraph * graph_;
+    VertexSet separator_;
+    ComponentMap labels_;
+    std::vector<std::size_t> sizes_;
+    std::vector<VertexIndexType> freeLabels_;
+    VertexIndexType nextLabel_;
+    std::size_t exploredVertices_;
+
+    // the scratch space of the split, the owner of a visited vertex is the search which reached it
+    Separator::Workspace workspace_;
+    std::vector<std::size_t> owners_;
+    std::vector<Search> searches_;
+
+    // per label scratch space for counting the full components
+    mutable std::vector<unsigned int> labelStamps_;
+    mutable std::vector<std::size_t> labelCounts_;
+    mutable unsigned int labelEpoch_;
+};
+
+} // namespace treeDAG
+
+#endif // TREEDAG_INCREMENTALSEPARATOR_HPP
@@ -0,0 +1,72 @@
+#include "iterativeDecomposer.hpp"
+#include "treewidthBound.hpp"
+
+namespace treeDAG {
+namespace {
+
+typedef boost::chrono::steady_clock Clock;
+
+} // namespace
+
+
+IterativeDecomposer::IterativeDecomposer(const CSRGraph * graph, std::size_t maxK)
+    : graph_(graph),
+      maxK_(maxK),
+      numberOfThreads_(1)
+{
+}
+
+
+void IterativeDecomposer::setNumberOfThreads(std::size_t numberOfThreads)
+{
+    numberOfThreads_ = numberOfThreads;
+}
+
+
+std::size_t IterativeDecomposer::numberOfThreads() const
+{
+    return numberOfThreads_;
+}
+
+
+std::size_t IterativeDecomposer::k() const
+{
+    return decomposer_ ? decomposer_->k() : 0;
+}
+
+
+void IterativeDecomposer::process(const VertexSet & roots)
+{
+    iterations_.clear();
+
+    // the smaller k have no decomposition
+    const std::size_t firstK = TreewidthBound(graph_).bound();
+    decomposer_.reset(new Decomposer(graph_, firstK));
+    decomposer_->setNumberOfThreads(numberOfThreads_);
+    decomposer_->setIncremental(true);
+
+    for(std::size_t k = firstK; k <= maxK_; ++k)
+    {
+        Iteration iteration;
+        iteration.k = k;
+
+        Clock::time_point start = Clock::now();
+        if(k == firstK)
+            decomposer_->initialize();
+        else
+            decomposer_->increaseK(k);
+        iteration.cacheTime = Clock::now() - start;
+
+        start = Clock::now();
+        decomposer_->process(roots.begin(), roots.end());
+        iteration.processTime = Clock::now() - start;
+
+        iteration.numberOfNodes = decomposer_->decompositionDAG().numberOfNodes();
+        iterations_.push_back(iteration);
+
+        if(iteration.numberOfNodes > 1)
+            break;
+    }
+}
+
+} // namespace treeDAG
@@ -0,0 +1,57 @@
+#ifndef TREEDAG_ITERATIVEDECOMPOSER_HPP
+#define TREEDAG_ITERATIVEDECOMPOSER_HPP
+
+#include "decomposer.hpp"
+#include <boost/chrono.hpp>
+#include <boost/scoped_ptr.hpp>
+
+namespace treeDAG {
+
+// finds the smallest k with a decomposition, by decomposing for increasing k with a single
+// incremental decomposer. It starts at the treewidth lower bound, and every next k keeps the
+// separators and the explored subgraph nodes of the previous ones
+class IterativeDecomposer : public SeparatorConfig
+{
+public:
+    struct Iteration
+    {
+        Iteration() : k(0), numberOfNodes(0), cacheTime(0), processTime(0) {}
+
+        std::size_t k;
+        // the nodes of the cleaned dag, only the root when there is no decomposition
+        std::size_t numberOfNodes;
+        boost::chrono::nanoseconds cacheTime;
+        boost::chrono::nanoseconds processTime;
+    };
+
+    IterativeDecomposer(const CSRGraph * graph, std::size_t maxK);
+
+    // the number of threads of the decomposer, zero for all available cores
+    void setNumberOfThreads(std::size_t numberOfThreads);
+    std::size_t numberOfThreads() const;
+
+    // returns whether there is a decomposition for some k up to the maximum
+    template <typename VertexIterator> bool process(VertexIterator firstRoot, VertexIterator lastRoot);
+
+    // the last k tried, which is the smallest feasible one after a successful process()
+    std::size_t k() const;
+    const std::vector<Iteration> & iterations() const { return iterations_; }
+
+    const DecompositionDAG & decompositionDAG() const { return decomposer_->decompositionDAG(); }
+    Decomposer & decomposer() { return *decomposer_; }
+
+private:
+    void process(const VertexSet & roots);
+
+    const CSRGraph * graph_;
+    std::size_t maxK_;
+    std::size_t numberOfThreads_;
+    boost::scoped_ptr<Decomposer> decomposer_;
+    std::vector<Iteration> iterations_;
+};
+
+} // namespace treeDAG
+
+#include "iterativeDecomposer.hxx"
+
+#endif // TREEDAG_ITERATIVEDECOMPOSER_HPP
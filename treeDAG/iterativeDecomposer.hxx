@@ -0,0 +1,19 @@
+#ifndef TREEDAG_ITERATIVEDECOMPOSER_HXX
+#define TREEDAG_ITERATIVEDECOMPOSER_HXX
+
+#include "iterativeDecomposer.hpp"
+
+namespace treeDAG {
+
+template <typename VertexIterator>
+bool IterativeDecomposer::process(VertexIterator firstRoot, VertexIterator lastRoot)
+{
+    std::set<VertexIndexType> roots(firstRoot, lastRoot);
+    process(VertexSet(roots.begin(), roots.end()));
+
+    return !iterations_.empty() && iterations_.back().numberOfNodes > 1;
+}
+
+} // namespace treeDAG
+
+#endif // TREEDAG_ITERATIVEDECOMPOSER_HXX
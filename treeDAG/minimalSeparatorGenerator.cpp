@@ -0,0 +1,117 @@
+#include "minimalSeparatorGenerator.hpp"
+#include <boost/unordered_set.hpp>
+#include <algorithm>
+#include <stack>
+
+namespace treeDAG {
+
+
+MinimalSeparatorGenerator::MinimalSeparatorGenerator(const CSRGraph * graph)
+    : graph_(graph),
+      separator_(graph)
+{
+}
+
+
+bool MinimalSeparatorGenerator::generate(std::size_t maxSize, std::vector<VertexSet> & separators, std::size_t separationsPerSeparator) const
+{
+    // every minimal separator should be processed exactly once, also the ones which are too large,
+    // as smaller separators can only be reached by closing the neighbourhood of larger ones
+    boost::unordered_set<VertexSet> seen;
+    std::stack<VertexSet> todo;
+
+    std::vector<VertexSet> found;
+    VertexSet removed;
+    boost::uint64_t separations = 0;
+
+    // the initial separators are the neighbourhoods of the components of G - N[v]
+    const std::size_t graphSize = graph_->numVertices();
+    for(VertexIndexType v = 0; v < graphSize; ++v)
+    {
+        closedNeighbourhood(v, removed);
+
+        found.clear();
+        addComponentNeighbourhoods(removed, found);
+
+        for(std::vector<VertexSet>::const_iterator it = found.begin(); it != found.end(); ++it)
+            if(seen.insert(*it).second)
+                todo.push(*it);
+    }
+
+    // and now close under S + N(x) for every x in S. The separations are paid for by the separators
+    // reported, so a closure mostly going over larger separators gives up
+    const std::size_t firstReported = separators.size();
+    while(!todo.empty())
+    {
+        VertexSet current = todo.top();
+        todo.pop();
+
+        if(current.size() <= maxSize)
+            separators.push_back(current);
+
+        const boost::uint64_t budget = boost::uint64_t(separationsPerSeparator) * (separators.size() - firstReported + 1);
+
+        for(VertexSet::const_iterator it = current.begin(); it != current.end(); ++it)
+        {
+            // construct S + N(x)
+            VertexSet neighbourhood;
+            closedNeighbourhood(*it, neighbourhood);
+
+            removed.clear();
+            std::set_union(current.begin(), current.end(), neighbourhood.begin(), neighbourhood.end(), std::back_inserter(removed));
+
+            if(separationsPerSeparator != 0 && ++separations > budget)
+                return false;
+
+            found.clear();
+            addComponentNeighbourhoods(removed, found);
+
+            for(std::vector<VertexSet>::const_iterator fit = found.begin(); fit != found.end(); ++fit)
+                if(seen.insert(*fit).second)
+                    todo.push(*fit);
+        }
+    }
+
+    return true;
+}
+
+
+void MinimalSeparatorGenerator::addComponentNeighbourhoods(const VertexSet & removed, std::vector<VertexSet> & found) const
+{
+    Separation & separation = separation_;
+    separator_.separate(removed.begin(), removed.end(), separation);
+
+    for(ComponentSet::const_iterator it = separation.components.begin(); it != separation.components.end(); ++it)
+    {
+        // the components contain their adjacent separator vertices, which is exactly the neighbourhood
+        VertexSet neighbourhood;
+        for(VertexSet::const_iterator vit = it->begin(); vit != it->end(); ++vit)
+            if(separation.componentMap[*vit] == SeparatorVertex())
+                neighbourhood.push_back(*vit);
+
+        // a component of another connected part of the graph
+        if(neighbourhood.empty())
+            continue;
+
+        found.push_back(neighbourhood);
+    }
+}
+
+
+void MinimalSeparatorGenerator::closedNeighbourhood(VertexIndexType vertex, VertexSet & neighbourhood) const
+{
+    typedef CSRGraph::AdjacencyIterator adjIt;
+
+    neighbourhood.clear();
+    neighbourhood.push_back(vertex);
+
+    for(std::pair<adjIt, adjIt> p = graph_->adjacentVertices(vertex); p.first != p.second; ++p.first)
+        neighbourhood.push_back(*p.first);
+
+    // make it a sorted set (there might be parallel edges)
+    std::sort(neighbourhood.begin(), neighbourhood.end());
+    neighbourhood.erase(std::unique(neighbourhood.begin(), neighbourhood.end()), neighbourhood.end());
+}
+
+
+} // namespace treeDAG
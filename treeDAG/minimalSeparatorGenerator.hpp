@@ -0,0 +1,36 @@
+#ifndef TREEDAG_MINIMALSEPARATORGENERATOR_HPP
+#define TREEDAG_MINIMALSEPARATORGENERATOR_HPP
+
+#include "separatorConfig.hpp"
+#include "separator.hpp"
+
+namespace treeDAG {
+
+// generates the minimal separators of a graph by closing neighbourhoods of
+// components (Berry, Bordat & Cogis), only those of at most maxSize vertices
+// are reported. The closure goes over the larger separators as well, so its
+// cost follows the number of all minimal separators, not only the small ones.
+class MinimalSeparatorGenerator : public SeparatorConfig
+{
+public:
+    typedef SeparatorConfig::Graph Graph;
+
+    explicit MinimalSeparatorGenerator(const CSRGraph * graph = 0);
+
+    // gives up and returns false when closing the separators has taken more than separationsPerSeparator
+    // separations of the graph per separator reported (plus one), zero for no limit. The separators
+    // reported so far are left in the vector
+    bool generate(std::size_t maxSize, std::vector<VertexSet> & separators, std::size_t separationsPerSeparator = 0) const;
+
+private:
+    void addComponentNeighbourhoods(const VertexSet & removed, std::vector<VertexSet> & found) const;
+    void closedNeighbourhood(VertexIndexType vertex, VertexSet & neighbourhood) const;
+
+    const CSRGraph * graph_;
+    Separator separator_;
+    mutable Separation separation_;
+};
+
+} // namespace treeDAG
+
+#endif // TREEDAG_MINIMALSEPARATORGENERATOR_HPP
@@ -0,0 +1,822 @@
+#include "separationStore.hpp"
+#include <boost/functional/hash.hpp>
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <numeric>
+#include <functional>
+#include <fstream>
+#include <stdexcept>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+namespace treeDAG {
+namespace {
+
+// the stored labels: the full components are numbered from FirstComponentLabel on
+const boost::uint32_t UnassignedLabel = 0;
+const boost::uint32_t SeparatorLabel = 1;
+const boost::uint32_t FirstComponentLabel = 2;
+
+std::size_t labelWidth(std::size_t numberOfComponents)
+{
+    const std::size_t maxLabel = numberOfComponents + FirstComponentLabel - 1;
+
+    if(maxLabel <= 0xFF)
+        return 1;
+    if(maxLabel <= 0xFFFF)
+        return 2;
+    return 4;
+}
+
+template <typename T>
+const T * pointer(const std::vector<T> & vector)
+{
+    return vector.empty() ? 0 : &vector[0];
+}
+
+// the saved file: a header with a table of sections, each section aligned on SectionAlignment bytes.
+// The data is in native byte order, which is checked with the byte order mark
+enum Section
+{
+    SECTION_Records,
+    SECTION_Separators,
+    SECTION_Labels,
+    SECTION_Ranks,
+    SECTION_SizeOffsets,
+    SECTION_TableOffsets,
+    SECTION_Tables,
+    SECTION_PresenceOffsets,
+    SECTION_Presence,
+    SectionCount
+};
+
+const char FileMagic[8] = { 'T', 'R', 'E', 'E', 'D', 'A', 'G', 'S' };
+const boost::uint32_t FileVersion = 1;
+const boost::uint32_t ByteOrderMark = 0x01020304;
+const std::size_t SectionAlignment = 64;
+
+struct FileHeader
+{
+    char magic[8];
+    boost::uint32_t version;
+    boost::uint32_t byteOrderMark;
+    boost::uint32_t vertexIndexSize;
+    boost::uint32_t recordSize;
+    boost::uint64_t key;
+    boost::uint64_t graphSize;
+    boost::uint64_t maxSize;
+    boost::uint64_t numberOfSizes;
+    boost::uint64_t sectionOffsets[SectionCount];
+    boost::uint64_t sectionSizes[SectionCount];
+};
+
+template <typename T>
+void writeSection(std::ostream & stream, FileHeader & header, Section section, const T * data, std::size_t count)
+{
+    const char padding[SectionAlignment] = {};
+    std::size_t position = stream.tellp();
+    std::size_t aligned = (position + SectionAlignment - 1) / SectionAlignment * SectionAlignment;
+    stream.write(padding, aligned - position);
+
+    header.sectionOffsets[section] = aligned;
+    header.sectionSizes[section] = count * sizeof(T);
+    if(count != 0)
+        stream.write(reinterpret_cast<const char *>(data), count * sizeof(T));
+}
+
+template <typename T>
+const T * readSection(const char * file, std::size_t fileSize, const FileHeader & header, Section section, std::size_t minimumCount)
+{
+    const boost::uint64_t offset = header.sectionOffsets[section];
+    const boost::uint64_t size = header.sectionSizes[section];
+
+    if(offset % SectionAlignment != 0 || offset > fileSize || size > fileSize - offset || size % sizeof(T) != 0 || size / sizeof(T) < minimumCount)
+        throw std::logic_error("SeparationStore: corrupt section in the separator file");
+
+    return size == 0 ? 0 : reinterpret_cast<const T *>(file + offset);
+}
+
+} // namespace
+
+
+SeparationView::SeparationView()
+    : store_(0),
+      record_(0)
+{
+}
+
+
+SeparationView::SeparationView(const SeparationStore * store, std::size_t record)
+    : store_(store),
+      record_(record)
+{
+}
+
+
+std::pair<SeparationView::VertexIterator, SeparationView::VertexIterator> SeparationView::separator() const
+{
+    return store_->separator(record_);
+}
+
+
+std::size_t SeparationView::separatorSize() const
+{
+    return store_->data_.records[record_].separatorSize;
+}
+
+
+std::size_t SeparationView::numberOfComponents() const
+{
+    return store_->data_.records[record_].numberOfComponents;
+}
+
+
+SeparationView::VertexIndexType SeparationView::componentOf(VertexIndexType vertex) const
+{
+    VertexIndexType label = store_->label(record_, vertex);
+
+    if(label == UnassignedLabel)
+        return UnassignedVertex();
+    if(label == SeparatorLabel)
+        return SeparatorVertex();
+    return label - FirstComponentLabel;
+}
+
+
+void SeparationView::components(ComponentSet & components) const
+{
+    components.resize(numberOfComponents());
+    for(ComponentSet::iterator it = components.begin(); it != components.end(); ++it)
+        it->clear();
+
+    // every full component is adjacent to all separator vertices
+    for(VertexIndexType v = 0; v < store_->graphSize_; ++v)
+    {
+        VertexIndexType label = store_->label(record_, v);
+
+        if(label == SeparatorLabel)
+            for(ComponentSet::iterator it = components.begin(); it != components.end(); ++it)
+                it->push_back(v);
+        else if(label != UnassignedLabel)
+            components[label - FirstComponentLabel].push_back(v);
+    }
+}
+
+
+void SeparationView::toSeparation(Separation & separation) const
+{
+    std::pair<VertexIterator, VertexIterator> sep = separator();
+    separation.separator.assign(sep.first, sep.second);
+
+    separation.componentMap.resize(store_->graphSize_);
+    for(VertexIndexType v = 0; v < store_->graphSize_; ++v)
+        separation.componentMap[v] = componentOf(v);
+
+    components(separation.components);
+}
+
+
+SeparationStore::Data::Data()
+    : records(0),
+      numberOfRecords(0),
+      separators(0),
+      separatorsSize(0),
+      labels(0),
+      labelsSize(0),
+      numberOfSizes(0),
+      ranks(0),
+      sizeOffsets(0),
+      tableOffsets(0),
+      tables(0),
+      presenceOffsets(0),
+      presence(0)
+{
+}
+
+
+SeparationStore::SeparationStore()
+    : graphSize_(0),
+      index_(0, RecordHash(this), RecordEqual(this)),
+      frozen_(false)
+{
+}
+
+
+SeparationStore::SeparationStore(const SeparationStore & other)
+    : index_(0, RecordHash(this), RecordEqual(this))
+{
+    *this = other;
+}
+
+
+SeparationStore & SeparationStore::operator=(const SeparationStore & other)
+{
+    if(this == &other)
+        return *this;
+
+    graphSize_ = other.graphSize_;
+    records_ = other.records_;
+    separatorArena_ = other.separatorArena_;
+    labelArena_ = other.labelArena_;
+    frozen_ = other.frozen_;
+    binomials_ = other.binomials_;
+    ranks_ = other.ranks_;
+    sizeOffsets_ = other.sizeOffsets_;
+    tableOffsets_ = other.tableOffsets_;
+    tables_ = other.tables_;
+    presenceOffsets_ = other.presenceOffsets_;
+    presence_ = other.presence_;
+
+    // a mapped file is shared
+    mapping_ = other.mapping_;
+    if(mapping_)
+        data_ = other.data_;
+    else
+        pointToVectors();
+
+    if(frozen_)
+        Index(0, RecordHash(this), RecordEqual(this)).swap(index_);
+    else
+        rebuildIndex();
+
+    return *this;
+}
+
+
+bool SeparationStore::insert(const Separation & separation)
+{
+    thaw();
+    if(find(separation.separator))
+        return false;
+
+    const VertexIndexType * sep = pointer(separation.separator);
+    const Record & record = addRecord(sep, sep + separation.separator.size(), separation.components.size(), separation.componentMap.size());
+    writeLabels(record, separation);
+
+    pointToVectors();
+    index_.insert(records_.size() - 1);
+    return true;
+}
+
+
+void SeparationStore::reserve(std::size_t graphSize, std::size_t records, std::size_t separatorVertices, std::size_t labelBytes)
+{
+    clear();
+    graphSize_ = graphSize;
+    records_.reserve(records);
+    separatorArena_.reserve(separatorVertices);
+    labelArena_.reserve(labelBytes);
+}
+
+
+bool SeparationStore::fits(const Separation & separation) const
+{
+    const std::size_t width = labelWidth(separation.components.size());
+    const std::size_t labelOffset = (labelArena_.size() + width - 1) / width * width;
+
+    return !frozen_ && !mapping_
+            && separation.componentMap.size() == graphSize_
+            && records_.size() < records_.capacity()
+            && separatorArena_.size() + separation.separator.size() <= separatorArena_.capacity()
+            && labelOffset + graphSize_ * width <= labelArena_.capacity();
+}
+
+
+SeparationView SeparationStore::append(const Separation & separation)
+{
+    assert(fits(separation));
+
+    const VertexIndexType * sep = pointer(separation.separator);
+    const Record & record = addRecord(sep, sep + separation.separator.size(), separation.components.size(), graphSize_);
+    writeLabels(record, separation);
+
+    // the vectors stay in place, so only the first append sets the pointers read by the views
+    if(records_.size() == 1)
+        pointToVectors();
+    else
+    {
+        data_.numberOfRecords = records_.size();
+        data_.separatorsSize = separatorArena_.size();
+        data_.labelsSize = labelArena_.size();
+    }
+
+    return SeparationView(this, records_.size() - 1);
+}
+
+
+void SeparationStore::writeLabels(const Record & record, const Separation & separation)
+{
+    // translate the component map
+    boost::uint8_t * labels = &labelArena_[record.labelOffset];
+    for(VertexIndexType v = 0; v < graphSize_; ++v)
+    {
+        VertexIndexType component = separation.componentMap[v];
+
+        boost::uint32_t label;
+        if(component == UnassignedVertex())
+            label = UnassignedLabel;
+        else if(component == SeparatorVertex())
+            label = SeparatorLabel;
+        else
+            label = component + FirstComponentLabel;
+
+        switch(record.labelWidth)
+        {
+        case 1: labels[v] = label; break;
+        case 2: reinterpret_cast<boost::uint16_t *>(labels)[v] = label; break;
+        default: reinterpret_cast<boost::uint32_t *>(labels)[v] = label; break;
+        }
+    }
+}
+
+
+bool SeparationStore::insert(const SeparationView & separation)
+{
+    std::pair<SeparationView::VertexIterator, SeparationView::VertexIterator> sep = separation.separator();
+    VertexSet separator(sep.first, sep.second);
+
+    thaw();
+    if(find(separator))
+        return false;
+
+    // the labels can be copied as they are
+    const SeparationStore & source = *separation.store_;
+    const Record & sourceRecord = source.data_.records[separation.record_];
+    Record & record = addRecord(&separator[0], &separator[0] + separator.size(), sourceRecord.numberOfComponents, source.graphSize_);
+    std::memcpy(&labelArena_[record.labelOffset], source.data_.labels + sourceRecord.labelOffset, graphSize_ * record.labelWidth);
+
+    pointToVectors();
+    index_.insert(records_.size() - 1);
+    return true;
+}
+
+
+SeparationView SeparationStore::find(const VertexSet & separator) const
+{
+    if(frozen_)
+        return findRanked(separator);
+
+    Index::const_iterator it = index_.find(separator, RecordHash(this), RecordEqual(this));
+    if(it == index_.end())
+        return SeparationView();
+
+    return SeparationView(this, *it);
+}
+
+
+std::pair<SeparationStore::Iterator, SeparationStore::Iterator> SeparationStore::separations() const
+{
+    return std::make_pair(Iterator(this, 0), Iterator(this, data_.numberOfRecords));
+}
+
+
+void SeparationStore::freeze()
+{
+    if(frozen_)
+        return;
+
+    std::size_t maxSize = 0;
+    for(std::vector<Record>::const_iterator it = records_.begin(); it != records_.end(); ++it)
+        maxSize = std::max<std::size_t>(maxSize, it->separatorSize);
+
+    // all the sizes should be rankable
+    util::BinomialTable binomials(graphSize_, maxSize);
+    for(std::size_t size = 0; size <= maxSize; ++size)
+        if(binomials(graphSize_, size) == util::BinomialTable::Overflow())
+            return;
+
+    binomials_ = binomials;
+
+    // sort the records on (size, rank)
+    std::vector<std::pair<std::pair<std::size_t, boost::uint64_t>, std::size_t> > order(records_.size());
+    for(std::size_t i = 0; i < records_.size(); ++i)
+    {
+        std::pair<const VertexIndexType *, const VertexIndexType *> sep = separator(i);
+        order[i] = std::make_pair(std::make_pair(records_[i].separatorSize, binomials_.rank(sep.first, sep.second)), i);
+    }
+    std::sort(order.begin(), order.end());
+
+    std::vector<Record> records(records_.size());
+    ranks_.resize(records_.size());
+    sizeOffsets_.assign(maxSize + 2, 0);
+    for(std::size_t i = 0; i < order.size(); ++i)
+    {
+        records[i] = records_[order[i].second];
+        ranks_[i] = order[i].first.second;
+        ++sizeOffsets_[order[i].first.first + 1];
+    }
+    records_.swap(records);
+
+    for(std::size_t size = 0; size <= maxSize; ++size)
+        sizeOffsets_[size + 1] += sizeOffsets_[size];
+
+    // the sizes with few subsets get a table from rank to record + 1, the others a bitmap of
+    // the ranks in use, as long as it is not too large
+    tableOffsets_.assign(1, 0);
+    presenceOffsets_.assign(1, 0);
+    tables_.clear();
+    presence_.clear();
+
+    for(std::size_t size = 0; size <= maxSize; ++size)
+    {
+        const boost::uint64_t subsets = binomials_(graphSize_, size);
+        const bool empty = sizeOffsets_[size] == sizeOffsets_[size + 1];
+
+        if(!empty && subsets <= MaxDirectTableSize)
+        {
+            const std::size_t first = tables_.size();
+            tables_.resize(first + subsets, 0);
+            for(std::size_t i = sizeOffsets_[size]; i < sizeOffsets_[size + 1]; ++i)
+                tables_[first + ranks_[i]] = i + 1;
+        }
+        else if(!empty && subsets <= MaxPresenceBitmapSize)
+        {
+            const std::size_t first = presence_.size();
+            presence_.resize(first + (subsets + 63) / 64, 0);
+            for(std::size_t i = sizeOffsets_[size]; i < sizeOffsets_[size + 1]; ++i)
+                presence_[first + ranks_[i] / 64] |= boost::uint64_t(1) << (ranks_[i] % 64);
+        }
+
+        tableOffsets_.push_back(tables_.size());
+        presenceOffsets_.push_back(presence_.size());
+    }
+
+    // the hash index is not needed anymore
+    Index(0, RecordHash(this), RecordEqual(this)).swap(index_);
+    frozen_ = true;
+    pointToVectors();
+}
+
+
+void SeparationStore::thaw()
+{
+    if(!frozen_)
+        return;
+
+    unmap();
+
+    frozen_ = false;
+    ranks_.clear();
+    sizeOffsets_.clear();
+    tableOffsets_.clear();
+    tables_.clear();
+    presenceOffsets_.clear();
+    presence_.clear();
+
+    pointToVectors();
+    rebuildIndex();
+}
+
+
+void SeparationStore::unmap()
+{
+    if(!mapping_)
+        return;
+
+    // copy everything out of the file
+    const Data & d = data_;
+    records_.assign(d.records, d.records + d.numberOfRecords);
+    separatorArena_.assign(d.separators, d.separators + d.separatorsSize);
+    labelArena_.assign(d.labels, d.labels + d.labelsSize);
+    ranks_.assign(d.ranks, d.ranks + d.numberOfRecords);
+    sizeOffsets_.assign(d.sizeOffsets, d.sizeOffsets + d.numberOfSizes + 1);
+    tableOffsets_.assign(d.tableOffsets, d.tableOffsets + d.numberOfSizes + 1);
+    tables_.assign(d.tables, d.tables + d.tableOffsets[d.numberOfSizes]);
+    presenceOffsets_.assign(d.presenceOffsets, d.presenceOffsets + d.numberOfSizes + 1);
+    presence_.assign(d.presence, d.presence + d.presenceOffsets[d.numberOfSizes]);
+
+    mapping_.reset();
+    pointToVectors();
+}
+
+
+void SeparationStore::pointToVectors()
+{
+    data_.records = pointer(records_);
+    data_.numberOfRecords = records_.size();
+    data_.separators = pointer(separatorArena_);
+    data_.separatorsSize = separatorArena_.size();
+    data_.labels = pointer(labelArena_);
+    data_.labelsSize = labelArena_.size();
+
+    data_.numberOfSizes = frozen_ ? sizeOffsets_.size() - 1 : 0;
+    data_.ranks = pointer(ranks_);
+    data_.sizeOffsets = pointer(sizeOffsets_);
+    data_.tableOffsets = pointer(tableOffsets_);
+    data_.tables = pointer(tables_);
+    data_.presenceOffsets = pointer(presenceOffsets_);
+    data_.presence = pointer(presence_);
+}
+
+
+void SeparationStore::save(const std::string & path, boost::uint64_t key, std::size_t maxSize) const
+{
+    if(!frozen_)
+        throw std::logic_error("SeparationStore: only a frozen store can be saved");
+
+    std::ofstream stream(path.c_str(), std::ios::binary | std::ios::trunc);
+    if(!stream)
+        throw std::logic_error("SeparationStore: cannot open " + path + " for writing");
+
+    // the separations are sorted on size, so the smaller sizes are a prefix of every section
+    const Data & d = data_;
+    const std::size_t numberOfSizes = std::min(d.numberOfSizes, maxSize + 1);
+    const std::size_t numberOfRecords = d.sizeOffsets[numberOfSizes];
+
+    FileHeader header = FileHeader();
+    std::copy(FileMagic, FileMagic + sizeof(FileMagic), header.magic);
+    header.version = FileVersion;
+    header.byteOrderMark = ByteOrderMark;
+    header.vertexIndexSize = sizeof(VertexIndexType);
+    header.recordSize = sizeof(Record);
+    header.key = key;
+    header.graphSize = graphSize_;
+    header.maxSize = maxSize;
+    header.numberOfSizes = numberOfSizes;
+
+    stream.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    writeSection(stream, header, SECTION_Records, d.records, numberOfRecords);
+    writeSection(stream, header, SECTION_Separators, d.separators, d.separatorsSize);
+    writeSection(stream, header, SECTION_Labels, d.labels, d.labelsSize);
+    writeSection(stream, header, SECTION_Ranks, d.ranks, numberOfRecords);
+    writeSection(stream, header, SECTION_SizeOffsets, d.sizeOffsets, numberOfSizes + 1);
+    writeSection(stream, header, SECTION_TableOffsets, d.tableOffsets, numberOfSizes + 1);
+    writeSection(stream, header, SECTION_Tables, d.tables, d.tableOffsets[numberOfSizes]);
+    writeSection(stream, header, SECTION_PresenceOffsets, d.presenceOffsets, numberOfSizes + 1);
+    writeSection(stream, header, SECTION_Presence, d.presence, d.presenceOffsets[numberOfSizes]);
+
+    // and now the header with the section table
+    stream.seekp(0);
+    stream.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+    if(!stream)
+        throw std::logic_error("SeparationStore: cannot write " + path);
+}
+
+
+void SeparationStore::load(const std::string & path, boost::uint64_t key, std::size_t maxSize)
+{
+    using namespace boost::interprocess;
+
+    boost::shared_ptr<mapped_region> region;
+    try
+    {
+        file_mapping file(path.c_str(), read_only);
+        region.reset(new mapped_region(file, read_only));
+    }
+    catch(const interprocess_exception & e)
+    {
+        throw std::logic_error("SeparationStore: cannot map " + path + ": " + e.what());
+    }
+
+    const char * file = static_cast<const char *>(region->get_address());
+    const std::size_t fileSize = region->get_size();
+
+    if(fileSize < sizeof(FileHeader))
+        throw std::logic_error("SeparationStore: " + path + " is not a separator file");
+
+    const FileHeader & header = *reinterpret_cast<const FileHeader *>(file);
+    if(!std::equal(FileMagic, FileMagic + sizeof(FileMagic), header.magic))
+        throw std::logic_error("SeparationStore: " + path + " is not a separator file");
+    if(header.version != FileVersion || header.byteOrderMark != ByteOrderMark || header.vertexIndexSize != sizeof(VertexIndexType) || header.recordSize != sizeof(Record))
+        throw std::logic_error("SeparationStore: " + path + " has an unsupported version or was written on another platform");
+    if(header.key != key)
+        throw std::logic_error("SeparationStore: " + path + " was saved for another graph");
+    if(header.maxSize < maxSize)
+        throw std::logic_error("SeparationStore: " + path + " was saved for smaller separators");
+
+    // keep only the sizes up to maxSize, which are a prefix
+    Data data;
+    const std::size_t savedSizes = header.numberOfSizes;
+    data.numberOfSizes = std::min<std::size_t>(savedSizes, maxSize + 1);
+
+    data.sizeOffsets = readSection<boost::uint64_t>(file, fileSize, header, SECTION_SizeOffsets, savedSizes + 1);
+    data.tableOffsets = readSection<boost::uint64_t>(file, fileSize, header, SECTION_TableOffsets, savedSizes + 1);
+    data.presenceOffsets = readSection<boost::uint64_t>(file, fileSize, header, SECTION_PresenceOffsets, savedSizes + 1);
+
+    // the offsets split the sections in slices per size, the last ones are the lengths of the sections
+    for(std::size_t size = 0; size < savedSizes; ++size)
+        if(data.sizeOffsets[size] > data.sizeOffsets[size + 1] || data.tableOffsets[size] > data.tableOffsets[size + 1] || data.presenceOffsets[size] > data.presenceOffsets[size + 1])
+            throw std::logic_error("SeparationStore: corrupt size offsets in the separator file");
+    if(data.sizeOffsets[0] != 0 || data.tableOffsets[0] != 0 || data.presenceOffsets[0] != 0)
+        throw std::logic_error("SeparationStore: corrupt size offsets in the separator file");
+
+    const std::size_t savedRecords = data.sizeOffsets[savedSizes];
+    data.numberOfRecords = data.sizeOffsets[data.numberOfSizes];
+    data.records = readSection<Record>(file, fileSize, header, SECTION_Records, savedRecords);
+    data.ranks = readSection<boost::uint64_t>(file, fileSize, header, SECTION_Ranks, savedRecords);
+    data.tables = readSection<boost::uint32_t>(file, fileSize, header, SECTION_Tables, data.tableOffsets[savedSizes]);
+    data.presence = readSection<boost::uint64_t>(file, fileSize, header, SECTION_Presence, data.presenceOffsets[savedSizes]);
+
+    data.separators = readSection<VertexIndexType>(file, fileSize, header, SECTION_Separators, 0);
+    data.separatorsSize = header.sectionSizes[SECTION_Separators] / sizeof(VertexIndexType);
+    data.labels = readSection<boost::uint8_t>(file, fileSize, header, SECTION_Labels, 0);
+    data.labelsSize = header.sectionSizes[SECTION_Labels];
+
+    // every record used should point inside the arenas, the views do not check this when reading
+    for(std::size_t i = 0; i < data.numberOfRecords; ++i)
+    {
+        const Record & record = data.records[i];
+
+        if(record.separatorOffset > data.separatorsSize || record.separatorSize > data.separatorsSize - record.separatorOffset)
+            throw std::logic_error("SeparationStore: corrupt separator offset in the separator file");
+        if((record.labelWidth != 1 && record.labelWidth != 2 && record.labelWidth != 4) || record.labelOffset % record.labelWidth != 0
+                || record.labelOffset > data.labelsSize || header.graphSize > (data.labelsSize - record.labelOffset) / record.labelWidth)
+            throw std::logic_error("SeparationStore: corrupt label offset in the separator file");
+    }
+
+    // and every rank looked up should land inside the slice of its size, which points at a record of that size
+    const util::BinomialTable binomials(header.graphSize, data.numberOfSizes == 0 ? 0 : data.numberOfSizes - 1);
+    for(std::size_t size = 0; size < data.numberOfSizes; ++size)
+    {
+        const boost::uint64_t subsets = binomials(header.graphSize, size);
+        const boost::uint64_t tableSize = data.tableOffsets[size + 1] - data.tableOffsets[size];
+        const boost::uint64_t presenceSize = data.presenceOffsets[size + 1] - data.presenceOffsets[size];
+
+        if(subsets == util::BinomialTable::Overflow() || data.sizeOffsets[size + 1] - data.sizeOffsets[size] > subsets
+                || (tableSize != 0 && tableSize != subsets) || (presenceSize != 0 && presenceSize != (subsets + 63) / 64))
+            throw std::logic_error("SeparationStore: corrupt rank tables in the separator file");
+
+        for(boost::uint64_t i = data.tableOffsets[size]; i < data.tableOffsets[size + 1]; ++i)
+            if(data.tables[i] != 0 && (data.tables[i] <= data.sizeOffsets[size] || data.tables[i] > data.sizeOffsets[size + 1]))
+                throw std::logic_error("SeparationStore: corrupt rank tables in the separator file");
+
+        // the separators are sorted sets of vertices of the graph, stored on their increasing ranks, so
+        // they are all different as the containment index expects
+        for(boost::uint64_t i = data.sizeOffsets[size]; i < data.sizeOffsets[size + 1]; ++i)
+        {
+            const Record & record = data.records[i];
+            const VertexIndexType * separator = data.separators + record.separatorOffset;
+
+            if(record.separatorSize != size || (size > 0 && separator[size - 1] >= header.graphSize)
+                    || std::adjacent_find(separator, separator + size, std::greater_equal<VertexIndexType>()) != separator + size
+                    || data.ranks[i] != binomials.rank(separator, separator + size) || (i > data.sizeOffsets[size] && data.ranks[i - 1] >= data.ranks[i]))
+                throw std::logic_error("SeparationStore: corrupt separator in the separator file");
+        }
+    }
+
+    // and replace the contents
+    clear();
+    graphSize_ = header.graphSize;
+    frozen_ = true;
+    binomials_ = binomials;
+    data_ = data;
+    mapping_ = region;
+}
+
+
+void SeparationStore::clear()
+{
+    graphSize_ = 0;
+    records_.clear();
+    separatorArena_.clear();
+    labelArena_.clear();
+    index_.clear();
+
+    frozen_ = false;
+    ranks_.clear();
+    sizeOffsets_.clear();
+    tableOffsets_.clear();
+    tables_.clear();
+    presenceOffsets_.clear();
+    presence_.clear();
+
+    mapping_.reset();
+    pointToVectors();
+}
+
+
+std::size_t SeparationStore::memoryUsage() const
+{
+    // the index nodes hold a record number and a link, the buckets a pointer
+    return records_.capacity() * sizeof(Record)
+            + separatorArena_.capacity() * sizeof(VertexIndexType)
+            + labelArena_.capacity()
+            + index_.size() * (sizeof(std::size_t) + sizeof(void *))
+            + index_.bucket_count() * sizeof(void *)
+            + (ranks_.capacity() + sizeOffsets_.capacity() + tableOffsets_.capacity() + presenceOffsets_.capacity() + presence_.capacity()) * sizeof(boost::uint64_t)
+            + tables_.capacity() * sizeof(boost::uint32_t);
+}
+
+
+SeparationStore::Record & SeparationStore::addRecord(const VertexIndexType * firstSeparator, const VertexIndexType * lastSeparator, std::size_t numberOfComponents, std::size_t graphSize)
+{
+    assert(records_.empty() || graphSize == graphSize_);
+    if(records_.empty())
+        graphSize_ = graphSize;
+
+    Record record;
+    record.separatorOffset = separatorArena_.size();
+    record.separatorSize = lastSeparator - firstSeparator;
+    record.numberOfComponents = numberOfComponents;
+    record.labelWidth = labelWidth(numberOfComponents);
+    record.reserved = 0;
+
+    // the labels are aligned on their width
+    record.labelOffset = (labelArena_.size() + record.labelWidth - 1) / record.labelWidth * record.labelWidth;
+
+    separatorArena_.insert(separatorArena_.end(), firstSeparator, lastSeparator);
+    labelArena_.resize(record.labelOffset + graphSize_ * record.labelWidth);
+
+    records_.push_back(record);
+    return records_.back();
+}
+
+
+std::pair<const SeparationStore::VertexIndexType *, const SeparationStore::VertexIndexType *> SeparationStore::separator(std::size_t record) const
+{
+    const Record & r = data_.records[record];
+    const VertexIndexType * first = data_.separators + r.separatorOffset;
+    return std::make_pair(first, first + r.separatorSize);
+}
+
+
+SeparationStore::VertexIndexType SeparationStore::label(std::size_t record, VertexIndexType vertex) const
+{
+    const boost::uint8_t * labels = data_.labels + data_.records[record].labelOffset;
+
+    switch(data_.records[record].labelWidth)
+    {
+    case 1: return labels[vertex];
+    case 2: return reinterpret_cast<const boost::uint16_t *>(labels)[vertex];
+    default: return reinterpret_cast<const boost::uint32_t *>(labels)[vertex];
+    }
+}
+
+
+SeparationView SeparationStore::findRanked(const VertexSet & separator) const
+{
+    assert(std::adjacent_find(separator.begin(), separator.end(), std::greater_equal<VertexIndexType>()) == separator.end());
+
+    const std::size_t size = separator.size();
+    if(size >= data_.numberOfSizes || (size > 0 && separator.back() >= graphSize_))
+        return SeparationView();
+
+    const boost::uint64_t r = binomials_.rank(separator.begin(), separator.end());
+
+    // a rank table
+    const boost::uint64_t firstEntry = data_.tableOffsets[size];
+    if(firstEntry != data_.tableOffsets[size + 1])
+    {
+        boost::uint32_t record = data_.tables[firstEntry + r];
+        return record == 0 ? SeparationView() : SeparationView(this, record - 1);
+    }
+
+    // or a bitmap in front of the binary search
+    const boost::uint64_t firstWord = data_.presenceOffsets[size];
+    if(firstWord != data_.presenceOffsets[size + 1] && !((data_.presence[firstWord + r / 64] >> (r % 64)) & 1))
+        return SeparationView();
+
+    const boost::uint64_t * first = data_.ranks + data_.sizeOffsets[size];
+    const boost::uint64_t * last = data_.ranks + data_.sizeOffsets[size + 1];
+    const boost::uint64_t * it = std::lower_bound(first, last, r);
+
+    if(it == last || *it != r)
+        return SeparationView();
+    return SeparationView(this, it - data_.ranks);
+}
+
+
+void SeparationStore::rebuildIndex()
+{
+    index_ = Index(records_.size(), RecordHash(this), RecordEqual(this));
+    for(std::size_t i = 0; i < records_.size(); ++i)
+        index_.insert(i);
+}
+
+std::size_t SeparationStore::RecordHash::operator()(std::size_t record) const
+{
+    std::pair<const VertexIndexType *, const VertexIndexType *> sep = store->separator(record);
+    return boost::hash_range(sep.first, sep.second);
+}
+
+
+std::size_t SeparationStore::RecordHash::operator()(const VertexSet & separator) const
+{
+    return boost::hash_range(separator.begin(), separator.end());
+}
+
+
+bool SeparationStore::RecordEqual::operator()(std::size_t lhs, std::size_t rhs) const
+{
+    std::pair<const VertexIndexType *, const VertexIndexType *> l = store->separator(lhs);
+    std::pair<const VertexIndexType *, const VertexIndexType *> r = store->separator(rhs);
+    return l.second - l.first == r.second - r.first && std::equal(l.first, l.second, r.first);
+}
+
+
+bool SeparationStore::RecordEqual::operator()(const VertexSet & lhs, std::size_t rhs) const
+{
+    std::pair<const VertexIndexType *, const VertexIndexType *> r = store->separator(rhs);
+    return std::size_t(r.second - r.first) == lhs.size() && std::equal(lhs.begin(), lhs.end(), r.first);
+}
+
+
+bool SeparationStore::RecordEqual::operator()(std::size_t lhs, const VertexSet & rhs) const
+{
+    return operator()(rhs, lhs);
+}
+
+
+} // namespace treeDAG
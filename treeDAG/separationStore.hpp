@@ -0,0 +1,215 @@
+#ifndef TREEDAG_SEPARATIONSTORE_HPP
+#define TREEDAG_SEPARATIONSTORE_HPP
+
+#include "separatorConfig.hpp"
+#include "separation.hpp"
+#include "util/binomial.hpp"
+#include <boost/unordered_set.hpp>
+#include <boost/iterator/iterator_facade.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/shared_ptr.hpp>
+#include <string>
+
+namespace treeDAG {
+
+class SeparationStore;
+
+// a read only view on a separation in a separation store, which converts to false when there is
+// no separation. Only the full components are stored, so a component is the set of vertices with
+// its label together with the complete separator
+class SeparationView : public SeparatorConfig
+{
+    typedef void (SeparationView::*bool_type)() const;
+    void safeBool() const {}
+
+public:
+    typedef const VertexIndexType * VertexIterator;
+
+    SeparationView();
+
+    operator bool_type() const { return store_ == 0 ? 0 : &SeparationView::safeBool; }
+
+    std::pair<VertexIterator, VertexIterator> separator() const;
+    std::size_t separatorSize() const;
+    std::size_t numberOfComponents() const;
+
+    // the index of the component containing the vertex, SeparatorVertex() for the separator vertices
+    // and UnassignedVertex() for the vertices which are not in a full component
+    VertexIndexType componentOf(VertexIndexType vertex) const;
+
+    // all components including the separator, in the same order as the components of the separation
+    void components(ComponentSet & components) const;
+    void toSeparation(Separation & separation) const;
+
+private:
+    friend class SeparationStore;
+
+    SeparationView(const SeparationStore * store, std::size_t record);
+
+    const SeparationStore * store_;
+    std::size_t record_;
+};
+
+
+// stores separations compactly: the separators in one shared arena, and per separation a label for
+// every vertex in another, using one, two or four bytes per label depending on the number of components.
+// A frozen store is indexed on the combinatorial rank of the separators instead of a hash set, and can
+// be saved to a file which is later mapped in memory and used in place
+class SeparationStore : public SeparatorConfig
+{
+public:
+    class Iterator : public boost::iterator_facade<Iterator, const SeparationView, boost::random_access_traversal_tag, SeparationView>
+    {
+    public:
+        Iterator() : store_(0), record_(0) {}
+        Iterator(const SeparationStore * store, std::size_t record) : store_(store), record_(record) {}
+
+    private:
+        friend class boost::iterator_core_access;
+
+        SeparationView dereference() const { return SeparationView(store_, record_); }
+        bool equal(const Iterator & other) const { return record_ == other.record_; }
+        void increment() { ++record_; }
+        void decrement() { --record_; }
+        void advance(std::ptrdiff_t n) { record_ += n; }
+        std::ptrdiff_t distance_to(const Iterator & other) const { return std::ptrdiff_t(other.record_) - std::ptrdiff_t(record_); }
+
+        const SeparationStore * store_;
+        std::size_t record_;
+    };
+
+    SeparationStore();
+    SeparationStore(const SeparationStore & other);
+    SeparationStore & operator=(const SeparationStore & other);
+
+    // adds the separation if its separator is not yet stored, the separation should be limited to its maximal components
+    bool insert(const Separation & separation);
+    bool insert(const SeparationView & separation);
+
+    // the separator should be sorted
+    SeparationView find(const VertexSet & separator) const;
+
+    // an append only store, whose separations can be read by other threads while more are appended:
+    // reserve() an empty store, then append() as long as the separation fits(). Nothing moves within the
+    // reserved room, so the views stay valid. The caller checks for duplicates and serializes the appends
+    void reserve(std::size_t graphSize, std::size_t records, std::size_t separatorVertices, std::size_t labelBytes);
+    bool fits(const Separation & separation) const;
+    SeparationView append(const Separation & separation);
+
+    // sorts the separations on (size, rank) and replaces the hash index by a rank index: a table
+    // indexed on rank when there are few subsets of a size, a binary search over the ranks otherwise,
+    // behind a bitmap of the present ranks so misses do not search. Inserting thaws the store again.
+    // Stores where some subset size cannot be ranked in 64 bits stay hashed
+    void freeze();
+    bool frozen() const { return frozen_; }
+
+    // the number of subsets of a size up to which a rank table, or a bitmap of the present ranks is used
+    static const std::size_t MaxDirectTableSize = 1 << 16;
+    static const std::size_t MaxPresenceBitmapSize = 1 << 26;
+
+    // saves a frozen store with all separators up to maxSize vertices. The key identifies the graph
+    void save(const std::string & path, boost::uint64_t key, std::size_t maxSize) const;
+
+    // maps a saved store for the same key in memory, and keeps only the separators up to maxSize vertices,
+    // which should be at most the size it was saved with. Throws a std::logic_error if the file does not fit
+    void load(const std::string & path, boost::uint64_t key, std::size_t maxSize);
+    bool mapped() const { return mapping_.get() != 0; }
+
+    std::size_t size() const { return data_.numberOfRecords; }
+    std::pair<Iterator, Iterator> separations() const;
+    void clear();
+
+    // the approximate number of bytes in use, a mapped file is not counted
+    std::size_t memoryUsage() const;
+
+private:
+    friend class SeparationView;
+
+    struct Record
+    {
+        boost::uint64_t separatorOffset;
+        boost::uint64_t labelOffset;
+        boost::uint32_t separatorSize;
+        boost::uint32_t numberOfComponents;
+        boost::uint32_t labelWidth;
+        boost::uint32_t reserved;
+    };
+
+    // all reads go through these, pointing either in the vectors below or in a mapped file. The
+    // tables of size s are [tableOffsets[s], tableOffsets[s+1]) in tables, the same for the bitmaps
+    struct Data
+    {
+        Data();
+
+        const Record * records;
+        std::size_t numberOfRecords;
+        const VertexIndexType * separators;
+        std::size_t separatorsSize;
+        const boost::uint8_t * labels;
+        std::size_t labelsSize;
+
+        // the rank index, only for a frozen store
+        std::size_t numberOfSizes;
+        const boost::uint64_t * ranks;
+        const boost::uint64_t * sizeOffsets;
+        const boost::uint64_t * tableOffsets;
+        const boost::uint32_t * tables;
+        const boost::uint64_t * presenceOffsets;
+        const boost::uint64_t * presence;
+    };
+
+    struct RecordHash
+    {
+        explicit RecordHash(const SeparationStore * store) : store(store) {}
+
+        std::size_t operator()(std::size_t record) const;
+        std::size_t operator()(const VertexSet & separator) const;
+
+        const SeparationStore * store;
+    };
+
+    struct RecordEqual
+    {
+        explicit RecordEqual(const SeparationStore * store) : store(store) {}
+
+        bool operator()(std::size_t lhs, std::size_t rhs) const;
+        bool operator()(const VertexSet & lhs, std::size_t rhs) const;
+        bool operator()(std::size_t lhs, const VertexSet & rhs) const;
+
+        const SeparationStore * store;
+    };
+
+    typedef boost::unordered_set<std::size_t, RecordHash, RecordEqual> Index;
+
+    Record & addRecord(const VertexIndexType * firstSeparator, const VertexIndexType * lastSeparator, std::size_t numberOfComponents, std::size_t graphSize);
+    void writeLabels(const Record & record, const Separation & separation);
+    std::pair<const VertexIndexType *, const VertexIndexType *> separator(std::size_t record) const;
+    VertexIndexType label(std::size_t record, VertexIndexType vertex) const;
+    void rebuildIndex();
+    void thaw();
+    void unmap();
+    void pointToVectors();
+    SeparationView findRanked(const VertexSet & separator) const;
+
+    std::size_t graphSize_;
+    std::vector<Record> records_;
+    VertexSet separatorArena_;
+    std::vector<boost::uint8_t> labelArena_;
+    Index index_;
+
+    bool frozen_;
+    util::BinomialTable binomials_;
+    std::vector<boost::uint64_t> ranks_;
+    std::vector<boost::uint64_t> sizeOffsets_;
+    std::vector<boost::uint64_t> tableOffsets_;
+    std::vector<boost::uint32_t> tables_;
+    std::vector<boost::uint64_t> presenceOffsets_;
+    std::vector<boost::uint64_t> presence_;
+
+    Data data_;
+    boost::shared_ptr<const void> mapping_;
+};
+
+} // namespace treeDAG
+
+#endif // TREEDAG_SEPARATIONSTORE_HPP
@@ -1,39 +1,74 @@
 #include "separator.hpp"
-#include <stack>
+#include <stdexcept>
 
 namespace treeDAG {
 
 
+Separator::Separator()
+    : graph_(0)
+{
+}
+
+
 Separator::Separator(const Graph * graph)
+    : graph_(0),
+      ownedGraph_(new CSRGraph(*graph))
+{
+    graph_ = ownedGraph_.get();
+}
+
+
+Separator::Separator(const CSRGraph * graph)
     : graph_(graph)
 {
 }
 
 
+void Separator::Workspace::nextEpoch(std::size_t graphSize)
+{
+    if(stamps.size() != graphSize)
+    {
+        stamps.assign(graphSize, 0);
+        separatorStamps.assign(graphSize, 0);
+        separatorPositions.resize(graphSize);
+        epoch = 0;
+    }
+
+    // only clear the stamps when the epoch wraps around
+    if(++epoch == 0)
+    {
+        std::fill(stamps.begin(), stamps.end(), 0);
+        std::fill(separatorStamps.begin(), separatorStamps.end(), 0);
+        epoch = 1;
+    }
+}
+
+
 std::size_t Separator::separateIntoComponentMap(const VertexSet & separator, ComponentMap & componentMap) const
 {
-    // make sure the component are the right size
-    assert(componentMap == std::vector<VertexIndexType>(boost::num_vertices(*graph_), UnassignedVertex()));
+    const VertexIndexType graphSize = graph_->numVertices();
+    workspace_.nextEpoch(graphSize);
+
+    // every entry of the component map is written below, so no need to reset it
+    componentMap.resize(graphSize);
 
     // set the separator
     for(VertexSet::const_iterator it = separator.begin(); it != separator.end(); ++it)
+    {
+        workspace_.visit(*it);
         componentMap[*it] = SeparatorVertex();
-
-    // get and iterator over the vertices, and go to the first non-separator vertex
-    std::pair<VertexIterator, VertexIterator> p = boost::vertices(*graph_);
-    p.first = findFirstNonSeparatorVertex(p.first, p.second, componentMap);
+    }
 
     std::size_t noComponents = 0;
 
-    while(p.first != p.second)
+    for(VertexIndexType current = 0; current < graphSize; ++current)
     {
-        // fill the component
-        fillCurrentComponent(*p.first, componentMap, noComponents);
-
-        // find the next iterator
-        p.first = findFirstNonSeparatorVertex(++p.first, p.second, componentMap);
+        // a separator vertex or already in a component
+        if(workspace_.visited(current))
+            continue;
 
-        // and next color
+        // fill the component, and next color
+        fillCurrentComponent(current, componentMap, noComponents);
         ++noComponents;
     }
 
@@ -41,6 +76,133 @@ std::size_t Separator::separateIntoComponentMap(const VertexSet & separator, Com
 }
 
 
+bool Separator::hasTwoFullComponents() const
+{
+    typedef CSRGraph::AdjacencyIterator adjIt;
+
+    const VertexSet & separator = workspace_.separator;
+    if(separator.empty())
+        return false;
+
+    workspace_.nextEpoch(graph_->numVertices());
+
+    // a full component is adjacent to every separator vertex, so it suffices to start from the
+    // neighbours of the separator vertex with the lowest degree
+    std::size_t start = 0;
+    for(std::size_t i = 0; i < separator.size(); ++i)
+    {
+        workspace_.visit(separator[i]);
+        workspace_.markSeparator(separator[i], i);
+
+        if(graph_->degree(separator[i]) < graph_->degree(separator[start]))
+            start = i;
+    }
+
+    workspace_.touchedBy.assign(separator.size(), UnassignedVertex());
+
+    std::size_t fullComponents = 0;
+    std::size_t componentNumber = 0;
+    for(std::pair<adjIt, adjIt> p = graph_->adjacentVertices(separator[start]); p.first != p.second; ++p.first)
+    {
+        if(workspace_.visited(*p.first))
+            continue;
+
+        // the second full component need not be explored completely
+        if(countAdjacentSeparatorVertices(*p.first, componentNumber++, fullComponents == 1) == separator.size() && ++fullComponents == 2)
+            return true;
+    }
+
+    return false;
+}
+
+
+std::size_t Separator::countAdjacentSeparatorVertices(VertexIndexType source, std::size_t componentNumber, bool stopWhenFull) const
+{
+    typedef CSRGraph::AdjacencyIterator adjIt;
+
+    const std::size_t separatorSize = workspace_.separator.size();
+    std::size_t count = 0;
+
+    std::vector<VertexIndexType> & todo = workspace_.stack;
+    todo.assign(1, source);
+    workspace_.visit(source);
+
+    while(!todo.empty())
+    {
+        VertexIndexType curV = todo.back();
+        todo.pop_back();
+
+        for(std::pair<adjIt, adjIt> p = graph_->adjacentVertices(curV); p.first != p.second; ++p.first)
+        {
+            if(workspace_.isSeparator(*p.first))
+            {
+                // count every separator vertex once per component
+                std::size_t & touchedBy = workspace_.touchedBy[workspace_.separatorPositions[*p.first]];
+                if(touchedBy != componentNumber)
+                {
+                    touchedBy = componentNumber;
+                    if(++count == separatorSize && stopWhenFull)
+                        return count;
+                }
+            }
+            else if(!workspace_.visited(*p.first))
+            {
+                workspace_.visit(*p.first);
+                todo.push_back(*p.first);
+            }
+        }
+    }
+
+    return count;
+}
+
+
+CSRGraph Separator::restrictToSubgraph() const
+{
+    VertexSet & subgraph = workspace_.subgraph;
+    std::sort(subgraph.begin(), subgraph.end());
+    subgraph.erase(std::unique(subgraph.begin(), subgraph.end()), subgraph.end());
+
+    VertexSet & separator = workspace_.separator;
+    std::sort(separator.begin(), separator.end());
+    separator.erase(std::unique(separator.begin(), separator.end()), separator.end());
+
+    // the separator in the numbering of the subgraph
+    workspace_.localSeparator.clear();
+    for(VertexSet::const_iterator it = separator.begin(); it != separator.end(); ++it)
+    {
+        VertexSet::const_iterator position = std::lower_bound(subgraph.begin(), subgraph.end(), *it);
+        if(position == subgraph.end() || *position != *it)
+            throw std::logic_error("Separator: the separator should be inside the subgraph");
+
+        workspace_.localSeparator.push_back(position - subgraph.begin());
+    }
+
+    return graph_->induced(subgraph);
+}
+
+
+void Separator::separateSubgraph(result_type & separation) const
+{
+    const CSRGraph local = restrictToSubgraph();
+    Separator(&local).separate(workspace_.localSeparator.begin(), workspace_.localSeparator.end(), separation);
+
+    // and back to the vertices of the graph, which keeps the order
+    const VertexSet & subgraph = workspace_.subgraph;
+    separation.separator = workspace_.separator;
+    for(ComponentSet::iterator it = separation.components.begin(); it != separation.components.end(); ++it)
+        for(VertexSet::iterator jt = it->begin(); jt != it->end(); ++jt)
+            *jt = subgraph[*jt];
+}
+
+
+bool Separator::isMinimalSeparatorInSubgraph() const
+{
+    const CSRGraph local = restrictToSubgraph();
+    return Separator(&local).isMinimalSeparator(workspace_.localSeparator.begin(), workspace_.localSeparator.end());
+}
+
+
 void Separator::fillComponents(const ComponentMap & componentMap, ComponentSet & components) const
 {
     // loop over the componentMap
@@ -53,8 +215,8 @@ void Separator::fillComponents(const ComponentMap & componentMap, ComponentSet &
         // a separator? then check the neighbours
         if(curComp == SeparatorVertex())
         {
-            typedef boost::graph_traits<Graph>::adjacency_iterator adjIt;
-            for(std::pair<adjIt,adjIt> p = boost::adjacent_vertices(curV, *graph_);p.first != p.second; ++p.first)
+            typedef CSRGraph::AdjacencyIterator adjIt;
+            for(std::pair<adjIt,adjIt> p = graph_->adjacentVertices(curV);p.first != p.second; ++p.first)
             {
                 // get the necessary information for the adjacent vertex
                 VertexIndexType adjV = *p.first;
@@ -78,46 +240,32 @@ void Separator::fillComponents(const ComponentMap & componentMap, ComponentSet &
 }
 
 
-Separator::VertexIterator
-Separator::findFirstNonSeparatorVertex(VertexIterator current, VertexIterator last, const ComponentMap &componentMap) const
-{
-    for(; current != last; ++current)
-    {
-        if(componentMap[*current] == UnassignedVertex())
-            return current;
-    }
-    return last;
-}
-
-
-
-
 void Separator::fillCurrentComponent(VertexIndexType source, ComponentMap & componentMap, std::size_t componentNumber) const
 {
-    typedef boost::graph_traits<Graph>::adjacency_iterator adjIt;
+    typedef CSRGraph::AdjacencyIterator adjIt;
 
-    std::stack<VertexIndexType> todo;
-    todo.push(source);
+    std::vector<VertexIndexType> & todo = workspace_.stack;
+    todo.clear();
+
+    workspace_.visit(source);
+    componentMap[source] = componentNumber;
+    todo.push_back(source);
 
     while(!todo.empty())
     {
         // get the next vertex to process
-        VertexIndexType curV = todo.top();
-        todo.pop();
-
-        // get the color
-        VertexIndexType & curColor = componentMap[curV];
-        assert(curColor == UnassignedVertex() || curColor == SeparatorVertex() || curColor == componentNumber);
+        VertexIndexType curV = todo.back();
+        todo.pop_back();
 
-        // unseen vertex
-        if(curColor == UnassignedVertex())
+        // and add the unseen neighbours to the todo
+        for(std::pair<adjIt, adjIt> p = graph_->adjacentVertices(curV); p.first != p.second; ++p.first)
         {
-            // set the color
-            curColor = componentNumber;
+            if(workspace_.visited(*p.first))
+                continue;
 
-            // add the neighbours to the todo
-            for(std::pair<adjIt, adjIt> p = boost::adjacent_vertices(curV, *graph_); p.first != p.second; ++p.first)
-                todo.push(*p.first);
+            workspace_.visit(*p.first);
+            componentMap[*p.first] = componentNumber;
+            todo.push_back(*p.first);
         }
     }
 }
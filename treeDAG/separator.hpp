@@ -3,30 +3,84 @@
 
 #include "separatorConfig.hpp"
 #include "separation.hpp"
+#include "csrGraph.hpp"
+#include <boost/shared_ptr.hpp>
 
 namespace treeDAG {
 
+// separates a graph into components, the scratch space is kept over the calls so a separator
+// should not be shared between threads
 class Separator : public SeparatorConfig
 {
 public:
     typedef SeparatorConfig::Graph                          Graph;
     typedef Separation                                      result_type;
-    typedef boost::graph_traits<Graph>::vertex_iterator     VertexIterator;
 
-    explicit Separator(const Graph * graph = 0);
+    Separator();
+    explicit Separator(const Graph * graph);
+    explicit Separator(const CSRGraph * graph);
 
     template <typename SeparatorVertexIterator> void separate(SeparatorVertexIterator first, SeparatorVertexIterator last, result_type & separation) const;
     template <typename SeparatorVertexIterator> result_type operator()(SeparatorVertexIterator first, SeparatorVertexIterator last) const;
     template <typename SeparatorVertexIterator> result_type operator()(const std::pair<SeparatorVertexIterator, SeparatorVertexIterator> & separatorRange) const;
 
+    // whether the vertices are a minimal separator, i.e. there are at least two full components. This
+    // stops as soon as the answer is known, and does not build the components
+    template <typename SeparatorVertexIterator> bool isMinimalSeparator(SeparatorVertexIterator first, SeparatorVertexIterator last) const;
+
+    // the same inside the subgraph induced by a sorted set of vertices, which should contain the separator.
+    // The induced graph is built and separated on its own, so the cost is in the subgraph and its degrees.
+    // The separator and the components are in the vertices of the graph, the component map is indexed on
+    // the positions in the set. Throws a std::logic_error when the separator is not inside the set
+    template <typename SubgraphVertexIterator, typename SeparatorVertexIterator>
+    void separateSubgraph(SubgraphVertexIterator firstVertex, SubgraphVertexIterator lastVertex, SeparatorVertexIterator first, SeparatorVertexIterator last, result_type & separation) const;
+    template <typename SubgraphVertexIterator, typename SeparatorVertexIterator>
+    bool isMinimalSeparatorInSubgraph(SubgraphVertexIterator firstVertex, SubgraphVertexIterator lastVertex, SeparatorVertexIterator first, SeparatorVertexIterator last) const;
+
+    // separates every candidate (a range of vertex containers), reusing the separations already in the output
+    template <typename CandidateIterator> void separateAll(CandidateIterator firstCandidate, CandidateIterator lastCandidate, std::vector<result_type> & separations) const;
+
+    // the scratch space, a vertex is visited during the current call iff its stamp equals the current
+    // epoch, so nothing has to be cleared between two calls
+    struct Workspace
+    {
+        Workspace() : epoch(0) {}
+
+        void nextEpoch(std::size_t graphSize);
+        bool visited(VertexIndexType vertex) const { return stamps[vertex] == epoch; }
+        void visit(VertexIndexType vertex) { stamps[vertex] = epoch; }
+
+        // the separator vertices of the current epoch, with their position in the separator
+        bool isSeparator(VertexIndexType vertex) const { return separatorStamps[vertex] == epoch; }
+        void markSeparator(VertexIndexType vertex, std::size_t position) { separatorStamps[vertex] = epoch; separatorPositions[vertex] = position; }
+
+        std::vector<unsigned int> stamps;
+        unsigned int epoch;
+        std::vector<VertexIndexType> stack;
+
+        std::vector<unsigned int> separatorStamps;
+        std::vector<std::size_t> separatorPositions;
+        VertexSet separator;
+        std::vector<std::size_t> touchedBy;
+
+        // the vertices of the subgraph, and the separator at their positions
+        VertexSet subgraph;
+        VertexSet localSeparator;
+    };
+
 private:
+    CSRGraph restrictToSubgraph() const;
+    void separateSubgraph(result_type & separation) const;
+    bool isMinimalSeparatorInSubgraph() const;
     std::size_t separateIntoComponentMap(const VertexSet & separator, ComponentMap & components) const;
-    VertexIterator findFirstNonSeparatorVertex(VertexIterator current, VertexIterator last, const ComponentMap & componentMap) const;
     void fillCurrentComponent(VertexIndexType source, ComponentMap & componentMap, std::size_t componentNumber) const;
     void fillComponents(const ComponentMap & componentMap, ComponentSet & components) const;
+    bool hasTwoFullComponents() const;
+    std::size_t countAdjacentSeparatorVertices(VertexIndexType source, std::size_t componentNumber, bool stopWhenFull) const;
 
-
-    const Graph * graph_;
+    const CSRGraph * graph_;
+    boost::shared_ptr<const CSRGraph> ownedGraph_;
+    mutable Workspace workspace_;
 };
 
 } // namespace treeDAG
@@ -2,25 +2,26 @@
 #define TREEDAG_SEPARATOR_HXX
 
 #include "separator.hpp"
-#include <stack>
+#include <algorithm>
 
 namespace treeDAG {
 
 template <typename SeparatorVertexIterator>
 void Separator::separate(SeparatorVertexIterator first, SeparatorVertexIterator last, result_type & separation) const
-{   
-    // set the separator
-    std::set<VertexIndexType> separator(first, last);
-    separation.separator.assign(separator.begin(), separator.end());
-
-    // reserve for the component map
-    separation.componentMap.assign(boost::num_vertices(*graph_), UnassignedVertex());
+{
+    // set the separator, as a sorted set
+    VertexSet & separator = separation.separator;
+    separator.assign(first, last);
+    std::sort(separator.begin(), separator.end());
+    separator.erase(std::unique(separator.begin(), separator.end()), separator.end());
 
     // separate into the map
     std::size_t noComponents = separateIntoComponentMap(separation.separator, separation.componentMap);
 
-    // create the space for the components
-    separation.components.assign(noComponents, VertexSet());
+    // create the space for the components, reusing the vectors already there
+    separation.components.resize(noComponents);
+    for(ComponentSet::iterator it = separation.components.begin(); it != separation.components.end(); ++it)
+        it->clear();
 
     // and now extract the different components (together with the adjacent separator vertices)
     fillComponents(separation.componentMap, separation.components);
@@ -43,6 +44,42 @@ Separator::operator()(const std::pair<SeparatorVertexIterator, SeparatorVertexIt
     return operator ()(separatorRange.first, separatorRange.second);
 }
 
+template <typename SeparatorVertexIterator>
+bool Separator::isMinimalSeparator(SeparatorVertexIterator first, SeparatorVertexIterator last) const
+{
+    VertexSet & separator = workspace_.separator;
+    separator.assign(first, last);
+    std::sort(separator.begin(), separator.end());
+    separator.erase(std::unique(separator.begin(), separator.end()), separator.end());
+
+    return hasTwoFullComponents();
+}
+
+template <typename SubgraphVertexIterator, typename SeparatorVertexIterator>
+void Separator::separateSubgraph(SubgraphVertexIterator firstVertex, SubgraphVertexIterator lastVertex, SeparatorVertexIterator first, SeparatorVertexIterator last, result_type & separation) const
+{
+    workspace_.subgraph.assign(firstVertex, lastVertex);
+    workspace_.separator.assign(first, last);
+    separateSubgraph(separation);
+}
+
+template <typename SubgraphVertexIterator, typename SeparatorVertexIterator>
+bool Separator::isMinimalSeparatorInSubgraph(SubgraphVertexIterator firstVertex, SubgraphVertexIterator lastVertex, SeparatorVertexIterator first, SeparatorVertexIterator last) const
+{
+    workspace_.subgraph.assign(firstVertex, lastVertex);
+    workspace_.separator.assign(first, last);
+    return isMinimalSeparatorInSubgraph();
+}
+
+template <typename CandidateIterator>
+void Separator::separateAll(CandidateIterator firstCandidate, CandidateIterator lastCandidate, std::vector<result_type> & separations) const
+{
+    separations.resize(std::distance(firstCandidate, lastCandidate));
+
+    for(std::size_t i = 0; firstCandidate != lastCandidate; ++firstCandidate, ++i)
+        separate(firstCandidate->begin(), firstCandidate->end(), separations[i]);
+}
+
 } // treeDAG namespace
 
 #endif // TREEDAG_SEPARATOR_HXX
@@ -1,77 +1,862 @@
 #include "separatorCache.hpp"
 #include "util/nChooseKIterator.hpp"
 #include "separator.hpp"
+#include "minimalSeparatorGenerator.hpp"
+#include "incrementalSeparator.hpp"
+#include "smallSeparatorGenerator.hpp"
+#include "util/revolvingDoor.hpp"
+#include "util/combinationIterator.hpp"
+#include "util/bitsetWord.hpp"
+#include <boost/thread.hpp>
+#include <boost/bind.hpp>
+#include <boost/unordered_set.hpp>
+#include <boost/functional/hash.hpp>
+#include <algorithm>
+#include <stdexcept>
 
 namespace treeDAG {
+namespace {
+
+typedef boost::chrono::steady_clock Clock;
+
+// the kernels of the lazy mode hold scratch space, so every query takes one from the pool
+template <typename Kernel>
+struct KernelPool
+{
+    explicit KernelPool(const Kernel & prototype) : prototype(prototype) {}
+
+    Kernel * acquire()
+    {
+        boost::lock_guard<boost::mutex> lock(mutex);
+        if(idle.empty())
+        {
+            kernels.push_back(boost::shared_ptr<Kernel>(new Kernel(prototype)));
+            return kernels.back().get();
+        }
+
+        Kernel * kernel = idle.back();
+        idle.pop_back();
+        return kernel;
+    }
+
+    void release(Kernel * kernel)
+    {
+        boost::lock_guard<boost::mutex> lock(mutex);
+        idle.push_back(kernel);
+    }
+
+    const Kernel prototype;
+    std::vector<boost::shared_ptr<Kernel> > kernels;
+    std::vector<Kernel *> idle;
+    boost::mutex mutex;
+};
+
+template <typename Kernel>
+class PooledKernel
+{
+public:
+    explicit PooledKernel(KernelPool<Kernel> & pool) : pool_(pool), kernel_(pool.acquire()) {}
+    ~PooledKernel() { pool_.release(kernel_); }
+
+    const Kernel & operator*() const { return *kernel_; }
+
+private:
+    PooledKernel(const PooledKernel &);
+    PooledKernel & operator=(const PooledKernel &);
+
+    KernelPool<Kernel> & pool_;
+    Kernel * kernel_;
+};
+
+// the separations in the lazy memo are hashed on their separator, which is looked up in the blocks
+struct SeparationViewHash
+{
+    std::size_t operator()(const SeparationView & separation) const { return boost::hash_range(separation.separator().first, separation.separator().second); }
+    std::size_t operator()(const SeparatorConfig::VertexSet & separator) const { return boost::hash_range(separator.begin(), separator.end()); }
+};
+
+struct SeparationViewEqual
+{
+    bool operator()(const SeparationView & lhs, const SeparationView & rhs) const
+    {
+        return lhs.separatorSize() == rhs.separatorSize() && std::equal(lhs.separator().first, lhs.separator().second, rhs.separator().first);
+    }
+
+    bool operator()(const SeparatorConfig::VertexSet & lhs, const SeparationView & rhs) const
+    {
+        return lhs.size() == rhs.separatorSize() && std::equal(lhs.begin(), lhs.end(), rhs.separator().first);
+    }
+};
+
+} // namespace
+
+
+// a part of the lazy memo, chosen on the hash of the separator. The separations found are appended to
+// blocks of growing size, which do not move what they hold, so the views stay valid without a lock.
+// The non separators are remembered by their rank per size
+struct SeparatorCache::LazyShard
+{
+    typedef boost::unordered_set<SeparationView, SeparationViewHash, SeparationViewEqual> SeparationSet;
+
+    // the label bytes of the first block, every next block doubles up to the last size
+    static const std::size_t FirstBlockBytes = 1 << 12;
+    static const std::size_t MaxBlockBytes = 1 << 20;
+
+    LazyShard() : blockBytes(0) {}
+
+    SeparationView append(const Separation & separation, std::size_t k);
+
+    SeparationSet separations;
+    std::vector<boost::shared_ptr<SeparationStore> > blocks;
+    std::size_t blockBytes;
+    std::vector<boost::unordered_set<boost::uint64_t> > negatives;
+    Separation separation;
+    boost::mutex mutex;
+};
+
+
+SeparationView SeparatorCache::LazyShard::append(const Separation & separation, std::size_t k)
+{
+    if(blocks.empty() || !blocks.back()->fits(separation))
+    {
+        // room for at least the separation with the widest labels, and the records for the narrowest
+        const std::size_t graphSize = separation.componentMap.size();
+        blockBytes = blockBytes == 0 ? std::size_t(FirstBlockBytes) : std::min(2 * blockBytes, std::size_t(MaxBlockBytes));
+        const std::size_t labelBytes = std::max(blockBytes, 4 * graphSize + 4);
+        const std::size_t records = labelBytes / std::max<std::size_t>(graphSize, 1) + 1;
+
+        blocks.push_back(boost::shared_ptr<SeparationStore>(new SeparationStore()));
+        blocks.back()->reserve(graphSize, records, records * std::max(k, separation.separator.size()), labelBytes);
+    }
+
+    SeparationView view = blocks.back()->append(separation);
+    separations.insert(view);
+    return view;
+}
+
+
+struct SeparatorCache::LazyState
+{
+    static const std::size_t NumberOfShards = 64;
+
+    LazyState(const CSRGraph * graph, std::size_t k, bool bitset)
+        : binomials(graph->numVertices(), k)
+    {
+        if(bitset)
+            bitsetKernels.reset(new KernelPool<BitsetSeparator<> >(BitsetSeparator<>(graph)));
+        else
+            kernels.reset(new KernelPool<Separator>(Separator(graph)));
+
+        for(std::size_t i = 0; i < NumberOfShards; ++i)
+            shards[i].negatives.resize(k + 1);
+    }
+
+    LazyShard & shard(const VertexSet & separator)
+    {
+        return shards[boost::hash_range(separator.begin(), separator.end()) % NumberOfShards];
+    }
+
+    util::BinomialTable binomials;
+    boost::scoped_ptr<KernelPool<Separator> > kernels;
+    boost::scoped_ptr<KernelPool<BitsetSeparator<> > > bitsetKernels;
+    LazyShard shards[NumberOfShards];
+};
+
+
+struct SeparatorCache::RankChunkQueue
+{
+    struct Chunk
+    {
+        std::size_t k;
+        boost::uint64_t first;
+        boost::uint64_t count;
+    };
+
+    RankChunkQueue(std::size_t n, std::size_t maxK)
+        : binomials(n, maxK),
+          next(0)
+    {
+    }
+
+    bool pop(Chunk & chunk)
+    {
+        boost::lock_guard<boost::mutex> lock(mutex);
+        if(next == chunks.size())
+            return false;
+
+        chunk = chunks[next++];
+        return true;
+    }
+
+    util::BinomialTable binomials;
+    std::vector<Chunk> chunks;
+    std::size_t next;
+    boost::mutex mutex;
+};
 
 
 SeparatorCache::SeparatorCache()
     : graph_(0),
-      k_(0)
+      k_(0),
+      firstSize_(1),
+      complete_(false),
+      rankIndex_(true),
+      method_(INIT_BruteForce),
+      numberOfThreads_(1),
+      kernel_(KERNEL_Automatic),
+      countLookups_(false),
+      lookups_(0),
+      hits_(0)
 {
 }
 
 
 SeparatorCache::SeparatorCache(std::size_t k, const Graph * graph)
+    : graph_(0),
+      ownedGraph_(new CSRGraph(*graph)),
+      k_(k),
+      firstSize_(1),
+      complete_(false),
+      rankIndex_(true),
+      method_(INIT_BruteForce),
+      numberOfThreads_(1),
+      kernel_(KERNEL_Automatic),
+      countLookups_(false),
+      lookups_(0),
+      hits_(0)
+{
+    graph_ = ownedGraph_.get();
+}
+
+
+SeparatorCache::SeparatorCache(std::size_t k, const CSRGraph * graph)
     : graph_(graph),
-      k_(k)
+      k_(k),
+      firstSize_(1),
+      complete_(false),
+      rankIndex_(true),
+      method_(INIT_BruteForce),
+      numberOfThreads_(1),
+      kernel_(KERNEL_Automatic),
+      countLookups_(false),
+      lookups_(0),
+      hits_(0)
+{
+}
+
+
+SeparatorCache::~SeparatorCache()
+{
+}
+
+
+void SeparatorCache::setInitializationMethod(InitializationMethod method)
+{
+    method_ = method;
+}
+
+
+SeparatorCache::InitializationMethod SeparatorCache::initializationMethod() const
 {
+    return method_;
+}
+
+
+void SeparatorCache::setNumberOfThreads(std::size_t numberOfThreads)
+{
+    numberOfThreads_ = numberOfThreads;
+}
+
+
+std::size_t SeparatorCache::numberOfThreads() const
+{
+    return numberOfThreads_;
+}
+
+
+void SeparatorCache::setSeparatorKernel(SeparatorKernel kernel)
+{
+    kernel_ = kernel;
+}
+
+
+SeparatorCache::SeparatorKernel SeparatorCache::separatorKernel() const
+{
+    return kernel_;
+}
+
+
+void SeparatorCache::setRankIndex(bool rankIndex)
+{
+    rankIndex_ = rankIndex;
+}
+
+
+bool SeparatorCache::rankIndex() const
+{
+    return rankIndex_;
+}
+
+
+void SeparatorCache::setCountLookups(bool countLookups)
+{
+    countLookups_ = countLookups;
+}
+
+
+bool SeparatorCache::countLookups() const
+{
+    return countLookups_;
+}
+
+
+SeparatorCache::LookupStatistics SeparatorCache::lookupStatistics() const
+{
+    LookupStatistics statistics;
+    statistics.lookups = lookups_.load(boost::memory_order_relaxed);
+    statistics.hits = hits_.load(boost::memory_order_relaxed);
+
+    return statistics;
+}
+
+
+void SeparatorCache::resetLookupStatistics()
+{
+    lookups_.store(0, boost::memory_order_relaxed);
+    hits_.store(0, boost::memory_order_relaxed);
+}
+
+
+const SeparatorCache::InitializationStatistics & SeparatorCache::statistics() const
+{
+    return statistics_;
 }
 
 
 void SeparatorCache::initialize()
-{    
+{
+    Clock::time_point start = Clock::now();
+    statistics_ = InitializationStatistics();
+    store_.clear();
+    containment_.clear();
+    lazy_.reset();
+    firstSize_ = 1;
+    complete_ = false;
+
+    if(method_ == INIT_Lazy)
+    {
+        // only prepare the kernels and the memo, everything else happens on the queries
+        lazy_.reset(new LazyState(graph_, k_, chosenKernel() == KERNEL_Bitset));
+    }
+    else
+        searchSeparators();
+
+    statistics_.time = Clock::now() - start;
+}
+
+
+std::size_t SeparatorCache::k() const
+{
+    return k_;
+}
+
+
+const CSRGraph * SeparatorCache::graph() const
+{
+    return graph_;
+}
+
+
+void SeparatorCache::increaseK(std::size_t k)
+{
+    if(k < k_)
+        throw std::logic_error("SeparatorCache: k can only be increased");
+
+    Clock::time_point start = Clock::now();
+    statistics_ = InitializationStatistics();
+
+    const std::size_t previousK = k_;
+    k_ = k;
+
+    // the lazy mode answers the larger queries as they come, it only needs the room to remember them
+    if(lazy_)
+    {
+        lazy_->binomials = util::BinomialTable(graph_->numVertices(), k_);
+        for(std::size_t i = 0; i < LazyState::NumberOfShards; ++i)
+            lazy_->shards[i].negatives.resize(k_ + 1);
+    }
+    // an initialized store keeps its separators, and only the new sizes are searched, also when it is hashed
+    else if(complete_ && k_ > previousK)
+    {
+        firstSize_ = previousK + 1;
+        searchSeparators();
+    }
+
+    statistics_.time = Clock::now() - start;
+}
+
+
+SeparatorCache::SeparatorKernel SeparatorCache::chosenKernel() const
+{
+    // the bitset kernel wins as long as its rows are short compared to the adjacency lists, with the
+    // average degree 2m/n: n <= size + perDegree * 2m/n
+    if(kernel_ == KERNEL_Automatic)
+    {
+        const std::size_t n = graph_->numVertices();
+        const std::size_t m = graph_->numEdges();
+        return n * n <= AutomaticBitsetSize * n + 2 * AutomaticBitsetSizePerDegree * m ? KERNEL_Bitset : KERNEL_Adjacency;
+    }
+
+    return kernel_;
+}
+
+
+void SeparatorCache::searchSeparators()
+{
+    if(chosenKernel() == KERNEL_Bitset)
+        initialize(BitsetSeparator<>(graph_));
+    else
+        initialize(Separator(graph_));
+
+    // from now on only lookups
+    if(rankIndex_)
+        store_.freeze();
+    buildLookupIndices();
+    complete_ = true;
+}
+
+
+template <typename Kernel>
+void SeparatorCache::initialize(const Kernel & kernel)
+{
+    switch(method_)
+    {
+    case INIT_BruteForce:
+        initializeSmallSeparators(kernel);
+        initializeBruteForce(kernel);
+        break;
+
+    case INIT_MinimalSeparatorGeneration:
+        initializeMinimalSeparatorGeneration(kernel);
+        break;
+
+    case INIT_RevolvingDoor:
+        initializeSmallSeparators(kernel);
+        initializeRevolvingDoor(kernel);
+        break;
+
+    case INIT_Lazy:
+        break;
+    }
+}
+
+
+template <typename Kernel>
+void SeparatorCache::initializeBruteForce(const Kernel & kernel)
+{
+    std::size_t numberOfThreads = numberOfThreads_ == 0 ? boost::thread::hardware_concurrency() : numberOfThreads_;
+    if(numberOfThreads > 1)
+    {
+        initializeBruteForceParallel(kernel, numberOfThreads);
+        return;
+    }
+
+    Clock::time_point start = Clock::now();
+    ThreadStatistics statistics;
+
     // initialize for all possible permutations of graph vertices
-    typedef boost::graph_traits<Graph>::vertex_iterator Vit;
+    typedef CSRGraph::VertexIterator Vit;
     typedef util::NChooseKIterator<typename std::vector<VertexIndexType>::iterator> CombIter;
 
     // store all the graph vertices
     VertexSet graphVertices;
-    std::pair<Vit, Vit> p = boost::vertices(*graph_);
+    std::pair<Vit, Vit> p = graph_->vertices();
     graphVertices.assign(p.first, p.second);
 
-    // loop over all permutations of (graphSize choose curK)
-    for(std::size_t curK = 1; curK <= k_; ++curK)
+    // the scratch space, reused for every candidate
+    Separation separation;
+
+    // loop over all permutations of (graphSize choose curK), the small ones are already there
+    for(std::size_t curK = std::max(SmallSeparatorGenerator::MaxSize + 1, firstSize_); curK <= k_ && curK <= graphVertices.size(); ++curK)
         for(std::pair<CombIter, CombIter> p = util::make_n_choose_k_iterators(graphVertices.begin(), graphVertices.end(), curK); p.first != p.second; ++p.first)
         {
-            const std::vector<VertexIndexType> & vct = *p.first;
-            processPossibleSeparator(*p.first);
+            processPossibleSeparator(kernel, p.first->begin(), p.first->end(), separation);
+            ++statistics.candidates;
         }
+
+    statistics.separators = store_.size();
+    statistics.time = Clock::now() - start;
+    statistics_.threads.push_back(statistics);
 }
 
 
-void SeparatorCache::processPossibleSeparator(const std::vector<VertexIndexType> &possibleSeparator)
+template <typename Kernel>
+void SeparatorCache::initializeBruteForceParallel(const Kernel & kernel, std::size_t numberOfThreads)
 {
-    // we need a separator
-    Separator separate(graph_);
+    const std::size_t graphSize = graph_->numVertices();
+    RankChunkQueue queue(graphSize, k_);
+
+    // split the rank space of every (graphSize choose curK) in chunks, a few per thread for the load balancing
+    for(std::size_t curK = std::max(SmallSeparatorGenerator::MaxSize + 1, firstSize_); curK <= k_ && curK <= graphSize; ++curK)
+    {
+        const boost::uint64_t total = queue.binomials(graphSize, curK);
+        const boost::uint64_t chunkSize = std::max<boost::uint64_t>(1, total / (8 * numberOfThreads));
+
+        for(boost::uint64_t first = 0; first < total; first += chunkSize)
+        {
+            RankChunkQueue::Chunk chunk;
+            chunk.k = curK;
+            chunk.first = first;
+            chunk.count = std::min(chunkSize, total - first);
+
+            queue.chunks.push_back(chunk);
+        }
+    }
+
+    // every thread gets its own result store
+    std::vector<SeparationStore> results(numberOfThreads);
+    statistics_.threads.assign(numberOfThreads, ThreadStatistics());
+
+    boost::thread_group threads;
+    for(std::size_t i = 0; i < numberOfThreads; ++i)
+        threads.create_thread(boost::bind(&SeparatorCache::bruteForceWorker<Kernel>, this, boost::cref(kernel), boost::ref(queue), boost::ref(results[i]), boost::ref(statistics_.threads[i])));
+    threads.join_all();
+
+    // and merge them
+    for(std::size_t i = 0; i < numberOfThreads; ++i)
+        for(std::pair<SeparatorIterator, SeparatorIterator> p = results[i].separations(); p.first != p.second; ++p.first)
+            store_.insert(*p.first);
+}
+
+
+template <typename Kernel>
+void SeparatorCache::bruteForceWorker(const Kernel & prototype, RankChunkQueue & queue, SeparationStore & results, ThreadStatistics & statistics) const
+{
+    typedef util::NChooseKIterator<VertexIndexType *> CombIter;
+
+    Clock::time_point start = Clock::now();
 
+    // the scratch space for this thread
+    Kernel separator(prototype);
+    Separation separation;
+
+    VertexSet graphVertices(graph_->numVertices());
+    for(std::size_t i = 0; i < graphVertices.size(); ++i)
+        graphVertices[i] = i;
+
+    RankChunkQueue::Chunk chunk;
+    while(queue.pop(chunk))
+    {
+        CombIter it(&graphVertices[0], graphVertices.size(), chunk.k, chunk.first, queue.binomials);
+
+        for(boost::uint64_t i = 0; i < chunk.count; ++i, ++it)
+        {
+            ++statistics.candidates;
+
+            if(findMinimalSeparation(separator, it->begin(), it->end(), separation))
+                results.insert(separation);
+        }
+    }
+
+    statistics.separators = results.size();
+    statistics.time = Clock::now() - start;
+}
+
+
+template <typename Kernel>
+void SeparatorCache::initializeMinimalSeparatorGeneration(const Kernel & kernel)
+{
+    Clock::time_point start = Clock::now();
+    ThreadStatistics statistics;
+
+    // generate the minimal separators directly, the cost scales with the number of all minimal separators,
+    // also the larger ones. So the brute force method takes over when the closure separates the graph
+    // more than ClosureSeparationsPerSeparator times for every separator of at most k vertices it finds
+    std::vector<VertexSet> separators;
+    const bool closed = MinimalSeparatorGenerator(graph_).generate(k_, separators, ClosureSeparationsPerSeparator);
+    statistics.candidates = separators.size();
+
+    if(closed)
+    {
+        // and store them in exactly the same way as the brute force method
+        Separation separation;
+        for(std::vector<VertexSet>::const_iterator it = separators.begin(); it != separators.end(); ++it)
+            if(it->size() >= firstSize_)
+                processPossibleSeparator(kernel, it->begin(), it->end(), separation);
+    }
+
+    statistics.separators = store_.size();
+    statistics.time = Clock::now() - start;
+    statistics_.threads.push_back(statistics);
+
+    if(!closed)
+    {
+        initializeSmallSeparators(kernel);
+        initializeBruteForce(kernel);
+    }
+}
+
+
+template <typename Kernel>
+void SeparatorCache::initializeRevolvingDoor(const Kernel & kernel)
+{
+    Clock::time_point start = Clock::now();
+    ThreadStatistics statistics;
+
+    const std::size_t graphSize = graph_->numVertices();
+    IncrementalSeparator incremental(graph_);
+    Separation separation;
+
+    // consecutive candidates differ in a single vertex, so the components are updated instead of
+    // recomputed, and only the minimal separators are separated completely
+    for(std::size_t curK = std::max(SmallSeparatorGenerator::MaxSize + 1, firstSize_); curK <= k_ && curK <= graphSize; ++curK)
+    {
+        util::RevolvingDoorCombination combination(graphSize, curK);
+        incremental.reset(combination.combination());
+
+        while(true)
+        {
+            ++statistics.candidates;
+
+            if(incremental.isMinimalSeparator())
+                processPossibleSeparator(kernel, incremental.separator().begin(), incremental.separator().end(), separation);
+
+            if(!combination.next())
+                break;
+
+            incremental.exchange(combination.removed(), combination.added());
+        }
+    }
+
+    statistics.separators = store_.size();
+    statistics.time = Clock::now() - start;
+    statistics_.threads.push_back(statistics);
+}
+
+
+template <typename Kernel>
+void SeparatorCache::initializeSmallSeparators(const Kernel & kernel)
+{
+    // the separators of one and two vertices follow from depth first searches, instead of
+    // separating all (graphSize choose 2) candidates
+    std::vector<VertexSet> separators;
+    if(firstSize_ > SmallSeparatorGenerator::MaxSize)
+        return;
+
+    SmallSeparatorGenerator(graph_).generate(k_, separators);
+
+    Separation separation;
+    for(std::vector<VertexSet>::const_iterator it = separators.begin(); it != separators.end(); ++it)
+        if(it->size() >= firstSize_)
+            processPossibleSeparator(kernel, it->begin(), it->end(), separation);
+}
+
+
+template <typename Kernel, typename VertexIterator>
+void SeparatorCache::processPossibleSeparator(const Kernel & separator, VertexIterator first, VertexIterator last, Separation & separation)
+{
     // find all the maximal components
-    Separation separation = separate(possibleSeparator.begin(), possibleSeparator.end());
+    if(!findMinimalSeparation(separator, first, last, separation))
+        return;
+
+    // now create a new separator and add it
+    store_.insert(separation);
+}
+
+
+template <typename Kernel, typename VertexIterator>
+bool SeparatorCache::findMinimalSeparation(const Kernel & separator, VertexIterator first, VertexIterator last, Separation & separation) const
+{
+    // most candidates are rejected, which is decided without building the components
+    if(!separator.isMinimalSeparator(first, last))
+        return false;
+
+    // find all the maximal components
+    separator.separate(first, last, separation);
     separation.limitToMaximalComponents();
 
     // only one component, then no minimal separator
-    if(separation.components.size() <= 1)
+    return separation.components.size() > 1;
+}
+
+
+SeparationView SeparatorCache::findSeparator(const VertexSet & separator) const
+{
+    // a loaded cache is complete up to k. The misses of a frozen store are rejected by the presence
+    // bitmap of the size, which reads a single word
+    SeparationView separation = lazy_ && !complete_ ? findSeparatorLazily(separator) : store_.find(separator);
+
+    if(countLookups_)
+    {
+        lookups_.fetch_add(1, boost::memory_order_relaxed);
+        if(separation)
+            hits_.fetch_add(1, boost::memory_order_relaxed);
+    }
+
+    return separation;
+}
+
+void SeparatorCache::findContainedSeparators(const VertexSet & set, std::vector<SeparationView> & separations) const
+{
+    typedef util::CombinationIterator<VertexSet::const_iterator> CombIt;
+
+    if(complete_)
+    {
+        containment_.findSubsets(set, store_, separations);
         return;
+    }
 
-    // now create a new separator and add it
-    map_.insert(separation);
+    // the store is not complete, so every subset has to be looked up
+    VertexSet subset;
+    subset.reserve(k_);
+
+    const std::size_t n = set.size();
+    if(n < 64)
+    {
+        // the subsets are the bits of a word, in the same order as the combination iterator
+        for(boost::uint64_t mask = 1; mask < (boost::uint64_t(1) << n); ++mask)
+        {
+            subset.clear();
+            for(boost::uint64_t bits = mask; bits != 0 && subset.size() <= k_; bits &= bits - 1)
+                subset.push_back(set[util::BitsetWordTraits<boost::uint64_t>::lowest(bits)]);
+
+            if(subset.size() > k_)
+                continue;
+
+            SeparationView separation = findSeparator(subset);
+            if(separation)
+                separations.push_back(separation);
+        }
+
+        return;
+    }
+
+    for(CombIt it = CombIt(set.begin(), set.end()); it != CombIt(); ++it)
+    {
+        subset.assign(it->begin(), it->end());
+        if(subset.empty() || subset.size() > k_)
+            continue;
+
+        SeparationView separation = findSeparator(subset);
+        if(separation)
+            separations.push_back(separation);
+    }
 }
 
+bool SeparatorCache::complete() const
+{
+    return complete_;
+}
 
-const Separation *
-SeparatorCache::findSeparator(const VertexSet & separator) const
+SeparationView SeparatorCache::findSeparatorLazily(const VertexSet & separator) const
 {
-    typename SeparatorMap::const_iterator it = map_.find(separator, SeparationHash(), SeparationEqual());
-    if(it == map_.end())
-        return 0;
+    const std::size_t size = separator.size();
+    if(size == 0 || size > k_ || separator.back() >= graph_->numVertices())
+        return SeparationView();
+
+    // the sizes which cannot be ranked are not remembered when negative
+    const bool ranked = lazy_->binomials(graph_->numVertices(), size) != util::BinomialTable::Overflow();
+    const boost::uint64_t rank = ranked ? lazy_->binomials.rank(separator.begin(), separator.end()) : 0;
+
+    // the shard stays locked while separating, so a separator is never separated twice
+    LazyShard & shard = lazy_->shard(separator);
+    boost::lock_guard<boost::mutex> lock(shard.mutex);
+
+    LazyShard::SeparationSet::const_iterator it = shard.separations.find(separator, SeparationViewHash(), SeparationViewEqual());
+    if(it != shard.separations.end())
+        return *it;
+
+    if(ranked && shard.negatives[size].count(rank) != 0)
+        return SeparationView();
+
+    bool found;
+    if(lazy_->bitsetKernels)
+        found = findMinimalSeparation(*PooledKernel<BitsetSeparator<> >(*lazy_->bitsetKernels), separator.begin(), separator.end(), shard.separation);
+    else
+        found = findMinimalSeparation(*PooledKernel<Separator>(*lazy_->kernels), separator.begin(), separator.end(), shard.separation);
 
-    return &*it;
+    if(!found)
+    {
+        if(ranked)
+            shard.negatives[size].insert(rank);
+        return SeparationView();
+    }
+
+    return shard.append(shard.separation, k_);
 }
 
 std::pair<SeparatorCache::SeparatorIterator, SeparatorCache::SeparatorIterator>
 SeparatorCache::separators() const
 {
-    return std::make_pair(map_.begin(), map_.end());
+    if(!lazy_ || complete_)
+        return store_.separations();
+
+    // collect the separations found in the shards, they are only ever added
+    std::size_t found = 0;
+    for(std::size_t i = 0; i < LazyState::NumberOfShards; ++i)
+    {
+        boost::lock_guard<boost::mutex> lock(lazy_->shards[i].mutex);
+        found += lazy_->shards[i].separations.size();
+    }
+
+    if(found != store_.size())
+    {
+        store_.clear();
+        for(std::size_t i = 0; i < LazyState::NumberOfShards; ++i)
+        {
+            LazyShard & shard = lazy_->shards[i];
+            boost::lock_guard<boost::mutex> lock(shard.mutex);
+
+            for(std::size_t b = 0; b < shard.blocks.size(); ++b)
+                for(std::pair<SeparatorIterator, SeparatorIterator> p = shard.blocks[b]->separations(); p.first != p.second; ++p.first)
+                    store_.insert(*p.first);
+        }
+    }
+
+    return store_.separations();
+}
+
+void SeparatorCache::save(const std::string & path) const
+{
+    if(method_ == INIT_Lazy && !complete_)
+        throw std::logic_error("SeparatorCache: a lazy cache cannot be saved");
+
+    store_.save(path, graph_->fingerprint(), k_);
+}
+
+void SeparatorCache::load(const std::string & path)
+{
+    statistics_ = InitializationStatistics();
+    firstSize_ = 1;
+    store_.load(path, graph_->fingerprint(), k_);
+    buildLookupIndices();
+    complete_ = true;
+}
+
+
+void SeparatorCache::buildLookupIndices()
+{
+    containment_.build(store_);
+    resetLookupStatistics();
+}
+
+std::size_t SeparatorCache::memoryUsage() const
+{
+    std::size_t lazy = 0;
+    for(std::size_t i = 0; lazy_ && i < LazyState::NumberOfShards; ++i)
+    {
+        LazyShard & shard = lazy_->shards[i];
+        boost::lock_guard<boost::mutex> lock(shard.mutex);
+
+        for(std::size_t b = 0; b < shard.blocks.size(); ++b)
+            lazy += sizeof(SeparationStore) + shard.blocks[b]->memoryUsage();
+        lazy += shard.separations.size() * (sizeof(SeparationView) + sizeof(void *)) + shard.separations.bucket_count() * sizeof(void *);
+
+        for(std::size_t s = 0; s < shard.negatives.size(); ++s)
+            lazy += shard.negatives[s].size() * (sizeof(boost::uint64_t) + sizeof(void *)) + shard.negatives[s].bucket_count() * sizeof(void *);
+    }
+
+    return store_.memoryUsage() + containment_.memoryUsage() + lazy;
 }
 
 
@@ -2,31 +2,183 @@
 #define TREEDAG_SEPARATORCACHE_HPP
 
 #include "separation.hpp"
+#include "separationStore.hpp"
+#include "containmentIndex.hpp"
+#include "separator.hpp"
+#include "bitsetSeparator.hpp"
+#include "util/binomial.hpp"
+#include <boost/atomic.hpp>
+#include <boost/chrono.hpp>
+#include <boost/scoped_ptr.hpp>
 
 namespace treeDAG {
 
 class SeparatorCache : public SeparatorConfig
 {
-    typedef boost::unordered_set<Separation, SeparationHash, SeparationEqual> SeparatorMap;
-
 public:
-    typedef typename SeparatorMap::const_iterator SeparatorIterator;
+    typedef SeparationStore::Iterator SeparatorIterator;
     typedef SeparatorConfig::Graph Graph;
 
+    enum InitializationMethod
+    {
+        INIT_BruteForce,
+        INIT_MinimalSeparatorGeneration,
+        INIT_RevolvingDoor,
+        // nothing is computed up front, findSeparator() separates on the first query and remembers the answer
+        INIT_Lazy
+    };
+
+    enum SeparatorKernel
+    {
+        KERNEL_Automatic,
+        KERNEL_Adjacency,
+        KERNEL_Bitset
+    };
+
+    // when the kernel is chosen automatically, the bitset kernel is used for graphs up to this size plus
+    // the second number per unit of average degree. Beyond that the rows of words cost more than the
+    // adjacency lists they replace, a grid of average degree four already breaks even near 800 vertices
+    static const std::size_t AutomaticBitsetSize = 512;
+    static const std::size_t AutomaticBitsetSizePerDegree = 96;
+
+    // the minimal separator generation gives up and leaves the separators to the brute force method when
+    // its closure separates the graph more often than this for each separator of at most k vertices found
+    static const std::size_t ClosureSeparationsPerSeparator = 64;
+
+    struct ThreadStatistics
+    {
+        ThreadStatistics() : candidates(0), separators(0), time(0) {}
+
+        std::size_t candidates;
+        std::size_t separators;
+        boost::chrono::nanoseconds time;
+    };
+
+    struct InitializationStatistics
+    {
+        InitializationStatistics() : time(0) {}
+
+        std::vector<ThreadStatistics> threads;
+        boost::chrono::nanoseconds time;
+    };
+
+    // the findSeparator() calls while they are counted, and how many found a separator
+    struct LookupStatistics
+    {
+        LookupStatistics() : lookups(0), hits(0) {}
+
+        std::size_t misses() const { return lookups - hits; }
+
+        std::size_t lookups;
+        std::size_t hits;
+    };
+
     SeparatorCache();
     SeparatorCache(std::size_t k, const Graph * graph);
+    SeparatorCache(std::size_t k, const CSRGraph * graph);
+    ~SeparatorCache();
+
+    void setInitializationMethod(InitializationMethod method);
+    InitializationMethod initializationMethod() const;
+
+    // the number of threads used for the brute force method (the revolving door method is sequential), zero for all available cores
+    void setNumberOfThreads(std::size_t numberOfThreads);
+    std::size_t numberOfThreads() const;
+
+    void setSeparatorKernel(SeparatorKernel kernel);
+    SeparatorKernel separatorKernel() const;
+
+    // indexes the initialized store on the rank of the separators instead of hashing them, which is on
+    // by default. The store stays hashed without it, or when some size cannot be ranked in 64 bits.
+    // Only a ranked store can be saved
+    void setRankIndex(bool rankIndex);
+    bool rankIndex() const;
 
     void initialize();
+    const InitializationStatistics & statistics() const;
+
+    // the largest separators searched, and the graph they separate
+    std::size_t k() const;
+    const CSRGraph * graph() const;
+
+    // raises k and keeps the separators found so far, an initialized or loaded cache only searches the
+    // separators of the new sizes. The lazy mode just answers the larger queries from now on. The
+    // statistics are the ones of the new sizes. Throws a std::logic_error when k would decrease
+    void increaseK(std::size_t k);
 
-    const Separation * findSeparator(const VertexSet & separator) const;
+    // counting is off by default, so the threads sharing a cache do not contend on the counters
+    void setCountLookups(bool countLookups);
+    bool countLookups() const;
+    LookupStatistics lookupStatistics() const;
+    void resetLookupStatistics();
+
+    // after initialize() or load() all lookups only read, so any number of threads can share the cache.
+    // The lazy mode computes a separation on its first query, and also allows concurrent queries: the
+    // answers are remembered in shards with their own lock, and the separations found stay in place
+    SeparationView findSeparator(const VertexSet & separator) const;
+
+    // in the lazy mode these are the separations found up to now, collected on the call. The range
+    // is replaced by the next call, so this should not be called concurrently in the lazy mode
     std::pair<SeparatorIterator, SeparatorIterator> separators() const;
 
+    // appends the stored separators which are subsets of the sorted set. An initialized or loaded cache
+    // answers this from a containment index, the lazy mode looks up every subset of at most k vertices
+    void findContainedSeparators(const VertexSet & set, std::vector<SeparationView> & separations) const;
+
+    // whether all separators are stored, so findContainedSeparators is cheap on large sets. The lazy
+    // mode only knows the separators it has been asked for
+    bool complete() const;
+
+    // the approximate number of bytes used by the stored separations
+    std::size_t memoryUsage() const;
+
+    // saves an initialized cache, and loads it again for the same graph: the file is mapped in memory and
+    // used as is. A file saved for a larger k can be loaded for a smaller one. Throws a std::logic_error
+    // when the file does not fit the graph or k
+    void save(const std::string & path) const;
+    void load(const std::string & path);
+
 private:
-    void processPossibleSeparator(const std::vector<VertexIndexType> &possibleSeparator);
+    struct RankChunkQueue;
+    struct LazyShard;
+    struct LazyState;
 
-    const Graph * graph_;
-    SeparatorMap map_;
+    SeparatorKernel chosenKernel() const;
+    void searchSeparators();
+    template <typename Kernel> void initialize(const Kernel & kernel);
+    template <typename Kernel> void initializeBruteForce(const Kernel & kernel);
+    template <typename Kernel> void initializeBruteForceParallel(const Kernel & kernel, std::size_t numberOfThreads);
+    template <typename Kernel> void initializeMinimalSeparatorGeneration(const Kernel & kernel);
+    template <typename Kernel> void initializeRevolvingDoor(const Kernel & kernel);
+    template <typename Kernel> void initializeSmallSeparators(const Kernel & kernel);
+    void buildLookupIndices();
+    template <typename Kernel> void bruteForceWorker(const Kernel & prototype, RankChunkQueue & queue, SeparationStore & results, ThreadStatistics & statistics) const;
+    template <typename Kernel, typename VertexIterator> void processPossibleSeparator(const Kernel & separator, VertexIterator first, VertexIterator last, Separation & separation);
+    SeparationView findSeparatorLazily(const VertexSet & separator) const;
+    template <typename Kernel, typename VertexIterator> bool findMinimalSeparation(const Kernel & separator, VertexIterator first, VertexIterator last, Separation & separation) const;
+
+    const CSRGraph * graph_;
+    boost::shared_ptr<const CSRGraph> ownedGraph_;
+    mutable SeparationStore store_;
+    ContainmentIndex containment_;
     std::size_t k_;
+    // the separators below this size are already stored, so the initialization skips them
+    std::size_t firstSize_;
+    // all separators up to k are stored, after initialize() or load() except in the lazy mode
+    bool complete_;
+    bool rankIndex_;
+    InitializationMethod method_;
+    std::size_t numberOfThreads_;
+    SeparatorKernel kernel_;
+    InitializationStatistics statistics_;
+
+    // the lookup counters
+    bool countLookups_;
+    mutable boost::atomic<std::size_t> lookups_;
+    mutable boost::atomic<std::size_t> hits_;
+
+    // the state of the lazy mode
+    boost::scoped_ptr<LazyState> lazy_;
 };
 
 } // namespace treeDAG
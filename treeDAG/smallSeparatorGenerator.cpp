@@ -0,0 +1,160 @@
+#include "smallSeparatorGenerator.hpp"
+#include <algorithm>
+
+namespace treeDAG {
+
+
+SmallSeparatorGenerator::SmallSeparatorGenerator(const CSRGraph * graph)
+    : graph_(graph),
+      time_(0)
+{
+}
+
+
+void SmallSeparatorGenerator::generate(std::size_t maxSize, std::vector<VertexSet> & separators) const
+{
+    typedef CSRGraph::AdjacencyIterator adjIt;
+
+    const std::size_t graphSize = graph_->numVertices();
+    std::vector<VertexIndexType> found;
+
+    // the articulation points, every part of G - v is adjacent to v
+    if(maxSize >= 1)
+    {
+        findArticulationPoints(UnassignedVertex(), found);
+        std::sort(found.begin(), found.end());
+
+        for(std::vector<VertexIndexType>::const_iterator it = found.begin(); it != found.end(); ++it)
+            separators.push_back(VertexSet(1, *it));
+    }
+
+    if(maxSize < 2)
+        return;
+
+    // the pairs, where the parts of G - u - v also have to be adjacent to u. Every pair is found from
+    // both of its vertices, so only the larger partners are kept
+    neighbourStamps_.assign(graphSize, UnassignedVertex());
+    for(VertexIndexType u = 0; u < graphSize; ++u)
+    {
+        for(std::pair<adjIt, adjIt> p = graph_->adjacentVertices(u); p.first != p.second; ++p.first)
+            neighbourStamps_[*p.first] = u;
+
+        found.clear();
+        findArticulationPoints(u, found);
+        std::sort(found.begin(), found.end());
+
+        for(std::vector<VertexIndexType>::const_iterator it = found.begin(); it != found.end(); ++it)
+            if(*it > u)
+            {
+                VertexSet separator(2, u);
+                separator[1] = *it;
+                separators.push_back(separator);
+            }
+    }
+}
+
+
+void SmallSeparatorGenerator::findArticulationPoints(VertexIndexType removed, std::vector<VertexIndexType> & found) const
+{
+    const std::size_t graphSize = graph_->numVertices();
+
+    discovered_.assign(graphSize, 0);
+    low_.resize(graphSize);
+    subtreeWeight_.resize(graphSize);
+    separatedWeight_.resize(graphSize);
+    fullParts_.resize(graphSize);
+    time_ = 0;
+
+    for(VertexIndexType root = 0; root < graphSize; ++root)
+        if(root != removed && discovered_[root] == 0)
+            search(root, removed, found);
+}
+
+
+void SmallSeparatorGenerator::search(VertexIndexType root, VertexIndexType removed, std::vector<VertexIndexType> & found) const
+{
+    order_.clear();
+    stack_.clear();
+
+    StackEntry entry;
+    entry.vertex = root;
+    entry.next = graph_->adjacentVertices(root).first;
+    stack_.push_back(entry);
+
+    discovered_[root] = low_[root] = ++time_;
+    subtreeWeight_[root] = weight(root, removed);
+    separatedWeight_[root] = fullParts_[root] = 0;
+    order_.push_back(root);
+
+    while(!stack_.empty())
+    {
+        StackEntry & top = stack_.back();
+        const VertexIndexType v = top.vertex;
+
+        if(top.next != graph_->adjacentVertices(v).second)
+        {
+            const VertexIndexType w = *top.next++;
+            if(w == removed)
+                continue;
+
+            if(discovered_[w] != 0)
+            {
+                // also the tree edge to the parent, which does not change the outcome
+                low_[v] = std::min(low_[v], discovered_[w]);
+                continue;
+            }
+
+            discovered_[w] = low_[w] = ++time_;
+            subtreeWeight_[w] = weight(w, removed);
+            separatedWeight_[w] = fullParts_[w] = 0;
+            order_.push_back(w);
+
+            entry.vertex = w;
+            entry.next = graph_->adjacentVertices(w).first;
+            stack_.push_back(entry);
+            continue;
+        }
+
+        // v is finished, pass it on to its parent
+        stack_.pop_back();
+        if(stack_.empty())
+            break;
+
+        const VertexIndexType parent = stack_.back().vertex;
+        low_[parent] = std::min(low_[parent], low_[v]);
+        subtreeWeight_[parent] += subtreeWeight_[v];
+
+        // the subtree of v is a part of G - parent
+        if(low_[v] >= discovered_[parent])
+        {
+            separatedWeight_[parent] += subtreeWeight_[v];
+            if(subtreeWeight_[v] > 0)
+                ++fullParts_[parent];
+        }
+    }
+
+    // the rest of the tree, outside v and its separated subtrees, is one more part
+    const std::size_t total = subtreeWeight_[root];
+    for(std::vector<VertexIndexType>::const_iterator it = order_.begin(); it != order_.end(); ++it)
+    {
+        std::size_t parts = fullParts_[*it];
+        if(*it != root && total - weight(*it, removed) - separatedWeight_[*it] > 0)
+            ++parts;
+
+        if(parts >= 2)
+            found.push_back(*it);
+    }
+}
+
+
+std::size_t SmallSeparatorGenerator::weight(VertexIndexType vertex, VertexIndexType removed) const
+{
+    // without a removed vertex every part counts, otherwise only the parts adjacent to it
+    if(removed == UnassignedVertex())
+        return 1;
+
+    return neighbourStamps_[vertex] == removed ? 1 : 0;
+}
+
+
+} // namespace treeDAG
@@ -0,0 +1,53 @@
+#ifndef TREEDAG_SMALLSEPARATORGENERATOR_HPP
+#define TREEDAG_SMALLSEPARATORGENERATOR_HPP
+
+#include "separatorConfig.hpp"
+#include "csrGraph.hpp"
+
+namespace treeDAG {
+
+// generates the minimal separators of one and two vertices with depth first searches: the
+// single vertices are the articulation points, and {u, v} is a minimal separator exactly when v
+// is an articulation point of G - u with at least two of its separated parts adjacent to u.
+// This is one search for the first size and one per vertex for the second one
+class SmallSeparatorGenerator : public SeparatorConfig
+{
+public:
+    typedef SeparatorConfig::Graph Graph;
+
+    // the largest separators which are generated
+    static const std::size_t MaxSize = 2;
+
+    explicit SmallSeparatorGenerator(const CSRGraph * graph = 0);
+
+    // the separators of at most maxSize (and at most MaxSize) vertices, as sorted sets reported by size
+    void generate(std::size_t maxSize, std::vector<VertexSet> & separators) const;
+
+private:
+    struct StackEntry
+    {
+        VertexIndexType vertex;
+        CSRGraph::AdjacencyIterator next;
+    };
+
+    void findArticulationPoints(VertexIndexType removed, std::vector<VertexIndexType> & found) const;
+    void search(VertexIndexType root, VertexIndexType removed, std::vector<VertexIndexType> & found) const;
+    std::size_t weight(VertexIndexType vertex, VertexIndexType removed) const;
+
+    const CSRGraph * graph_;
+
+    // scratch space of the searches
+    mutable std::vector<std::size_t> discovered_;
+    mutable std::vector<std::size_t> low_;
+    mutable std::vector<std::size_t> subtreeWeight_;
+    mutable std::vector<std::size_t> separatedWeight_;
+    mutable std::vector<std::size_t> fullParts_;
+    mutable std::vector<VertexIndexType> neighbourStamps_;
+    mutable std::vector<VertexIndexType> order_;
+    mutable std::vector<StackEntry> stack_;
+    mutable std::size_t time_;
+};
+
+} // namespace treeDAG
+
+#endif // TREEDAG_SMALLSEPARATORGENERATOR_HPP
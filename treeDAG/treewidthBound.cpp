@@ -0,0 +1,121 @@
+#include "treewidthBound.hpp"
+#include <algorithm>
+
+namespace treeDAG {
+
+
+TreewidthBound::TreewidthBound()
+    : graph_(0),
+      degeneracy_(0),
+      minorMinWidth_(0),
+      contractionDegeneracy_(0)
+{
+}
+
+
+TreewidthBound::TreewidthBound(const CSRGraph * graph)
+    : graph_(graph)
+{
+    degeneracy_ = computeBound(BOUND_Degeneracy);
+    minorMinWidth_ = computeBound(BOUND_MinorMinWidth);
+    contractionDegeneracy_ = computeBound(BOUND_ContractionDegeneracy);
+}
+
+
+std::size_t TreewidthBound::bound(BoundMethod method) const
+{
+    switch(method)
+    {
+    case BOUND_Degeneracy:
+        return degeneracy_;
+    case BOUND_MinorMinWidth:
+        return minorMinWidth_;
+    case BOUND_ContractionDegeneracy:
+        return contractionDegeneracy_;
+    }
+
+    return 0;
+}
+
+
+std::size_t TreewidthBound::bound() const
+{
+    return std::max(degeneracy_, std::max(minorMinWidth_, contractionDegeneracy_));
+}
+
+
+std::size_t TreewidthBound::computeBound(BoundMethod method) const
+{
+    typedef CSRGraph::AdjacencyIterator adjIt;
+    typedef std::set<VertexIndexType>::const_iterator setIt;
+    typedef std::pair<std::size_t, VertexIndexType> DegreeEntry;
+
+    const std::size_t graphSize = graph_->numVertices();
+
+    std::vector<std::set<VertexIndexType> > adjacency(graphSize);
+    for(VertexIndexType v = 0; v < graphSize; ++v)
+        for(std::pair<adjIt, adjIt> p = graph_->adjacentVertices(v); p.first != p.second; ++p.first)
+            if(*p.first != v)
+                adjacency[v].insert(*p.first);
+
+    std::set<DegreeEntry> order;
+    for(VertexIndexType v = 0; v < graphSize; ++v)
+        order.insert(std::make_pair(adjacency[v].size(), v));
+
+    std::size_t bound = 0;
+    while(!order.empty())
+    {
+        const VertexIndexType v = order.begin()->second;
+        bound = std::max(bound, order.begin()->first);
+        order.erase(order.begin());
+
+        std::set<VertexIndexType> & neighbours = adjacency[v];
+
+        // the neighbour v is contracted into, none when deleting
+        VertexIndexType target = UnassignedVertex();
+        if(method != BOUND_Degeneracy && !neighbours.empty())
+        {
+            std::size_t best = 0;
+            for(setIt it = neighbours.begin(); it != neighbours.end(); ++it)
+            {
+                std::size_t score = adjacency[*it].size();
+                if(method == BOUND_ContractionDegeneracy)
+                {
+                    score = 0;
+                    for(setIt nIt = adjacency[*it].begin(); nIt != adjacency[*it].end(); ++nIt)
+                        score += neighbours.count(*nIt);
+                }
+
+                if(target == UnassignedVertex() || score < best)
+                {
+                    target = *it;
+                    best = score;
+                }
+            }
+        }
+
+        for(setIt it = neighbours.begin(); it != neighbours.end(); ++it)
+        {
+            const VertexIndexType w = *it;
+            order.erase(std::make_pair(adjacency[w].size(), w));
+            adjacency[w].erase(v);
+
+            // the other neighbours of v become neighbours of the target
+            if(target != UnassignedVertex() && w != target && adjacency[target].count(w) == 0)
+            {
+                order.erase(std::make_pair(adjacency[target].size(), target));
+                adjacency[target].insert(w);
+                adjacency[w].insert(target);
+                order.insert(std::make_pair(adjacency[target].size(), target));
+            }
+
+            order.insert(std::make_pair(adjacency[w].size(), w));
+        }
+
+        neighbours.clear();
+    }
+
+    return bound;
+}
+
+} // namespace treeDAG
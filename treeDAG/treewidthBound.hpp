@@ -0,0 +1,46 @@
+#ifndef TREEDAG_TREEWIDTHBOUND_HPP
+#define TREEDAG_TREEWIDTHBOUND_HPP
+
+#include "separatorConfig.hpp"
+#include "csrGraph.hpp"
+#include <set>
+
+namespace treeDAG {
+
+// lower bounds on the treewidth of a graph, which take a few passes over the graph instead of the
+// separator search. Every bound is the largest minimum degree seen while repeatedly taking a vertex
+// of minimum degree out of the graph: the degeneracy deletes it, the contraction bounds contract it
+// into a neighbour, which keeps a minor of the graph and so a lower bound on its treewidth
+class TreewidthBound : public SeparatorConfig
+{
+public:
+    enum BoundMethod
+    {
+        // delete the vertex, the maximum minimum degree over all subgraphs
+        BOUND_Degeneracy,
+        // contract the vertex into the neighbour of minimum degree (minor-min-width)
+        BOUND_MinorMinWidth,
+        // contract the vertex into the neighbour with the fewest common neighbours
+        BOUND_ContractionDegeneracy
+    };
+
+    TreewidthBound();
+    explicit TreewidthBound(const CSRGraph * graph);
+
+    std::size_t bound(BoundMethod method) const;
+
+    // the best of all bounds
+    std::size_t bound() const;
+
+private:
+    std::size_t computeBound(BoundMethod method) const;
+
+    const CSRGraph * graph_;
+    std::size_t degeneracy_;
+    std::size_t minorMinWidth_;
+    std::size_t contractionDegeneracy_;
+};
+
+} // namespace treeDAG
+
+#endif // TREEDAG_TREEWIDTHBOUND_HPP
@@ -0,0 +1,44 @@
+#include "binomial.hpp"
+#include <cassert>
+
+namespace treeDAG {
+namespace util {
+
+BinomialTable::BinomialTable()
+    : maxN_(0),
+      maxK_(0),
+      table_(1, 1)
+{
+}
+
+BinomialTable::BinomialTable(std::size_t maxN, std::size_t maxK)
+    : maxN_(maxN),
+      maxK_(maxK),
+      table_((maxN + 1) * (maxK + 1), 0)
+{
+    // pascal's triangle, saturating on overflow
+    for(std::size_t n = 0; n <= maxN_; ++n)
+    {
+        table_[n * (maxK_ + 1)] = 1;
+
+        for(std::size_t k = 1; k <= maxK_ && k <= n; ++k)
+        {
+            boost::uint64_t lhs = table_[(n - 1) * (maxK_ + 1) + k - 1];
+            boost::uint64_t rhs = table_[(n - 1) * (maxK_ + 1) + k];
+
+            table_[n * (maxK_ + 1) + k] = (lhs > Overflow() - rhs) ? Overflow() : lhs + rhs;
+        }
+    }
+}
+
+boost::uint64_t BinomialTable::operator()(std::size_t n, std::size_t k) const
+{
+    if(k > n)
+        return 0;
+
+    assert(n <= maxN_ && k <= maxK_);
+    return table_[n * (maxK_ + 1) + k];
+}
+
+} // namespace util
+} // namespace treeDAG
@@ -0,0 +1,40 @@
+#ifndef TREEDAG_UTIL_BINOMIAL_HPP
+#define TREEDAG_UTIL_BINOMIAL_HPP
+
+#include <boost/cstdint.hpp>
+#include <vector>
+#include <limits>
+
+namespace treeDAG {
+namespace util {
+
+// a table with all binomial coefficients (n choose k) for n <= maxN and k <= maxK. Values which
+// do not fit in 64 bits are saturated to Overflow()
+class BinomialTable
+{
+public:
+    BinomialTable();
+    BinomialTable(std::size_t maxN, std::size_t maxK);
+
+    boost::uint64_t operator()(std::size_t n, std::size_t k) const;
+
+    // the rank of a sorted subset v_1 < ... < v_s in the combinatorial number system, sum (v_i choose i)
+    template <typename Iterator> boost::uint64_t rank(Iterator first, Iterator last) const;
+
+    std::size_t maxN() const { return maxN_; }
+    std::size_t maxK() const { return maxK_; }
+
+    static boost::uint64_t Overflow() { return std::numeric_limits<boost::uint64_t>::max(); }
+
+private:
+    std::size_t maxN_;
+    std::size_t maxK_;
+    std::vector<boost::uint64_t> table_;
+};
+
+} // namespace util
+} // namespace treeDAG
+
+#include "binomial.hxx"
+
+#endif // TREEDAG_UTIL_BINOMIAL_HPP
@@ -0,0 +1,22 @@
+#ifndef TREEDAG_UTIL_BINOMIAL_HXX
+#define TREEDAG_UTIL_BINOMIAL_HXX
+
+#include "binomial.hpp"
+
+namespace treeDAG {
+namespace util {
+
+template <typename Iterator>
+boost::uint64_t BinomialTable::rank(Iterator first, Iterator last) const
+{
+    boost::uint64_t result = 0;
+    for(std::size_t i = 1; first != last; ++first, ++i)
+        result += operator()(*first, i);
+
+    return result;
+}
+
+} // namespace util
+} // namespace treeDAG
+
+#endif // TREEDAG_UTIL_BINOMIAL_HXX
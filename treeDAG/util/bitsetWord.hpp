@@ -0,0 +1,129 @@
+#ifndef TREEDAG_UTIL_BITSETWORD_HPP
+#define TREEDAG_UTIL_BITSETWORD_HPP
+
+#include <boost/cstdint.hpp>
+#include <climits>
+#include <cstddef>
+
+namespace treeDAG {
+namespace util {
+
+// the operations on a single word of a bitset, specialized for the vector types below. The
+// bitset loops only use |, & and ~ on words, so the compiler can vectorize them
+template <typename Word>
+struct BitsetWordTraits
+{
+    static const std::size_t Bits = sizeof(Word) * CHAR_BIT;
+
+    static Word zero() { return Word(0); }
+    static bool isZero(const Word & word) { return word == 0; }
+    static void set(Word & word, std::size_t bit) { word |= Word(1) << bit; }
+    static void reset(Word & word, std::size_t bit) { word &= ~(Word(1) << bit); }
+    static bool test(const Word & word, std::size_t bit) { return (word >> bit) & Word(1); }
+
+    // the position of the lowest bit, the word should not be zero
+    static std::size_t lowest(const Word & word)
+    {
+        std::size_t bit = 0;
+        while(!test(word, bit))
+            ++bit;
+        return bit;
+    }
+
+    // calls visitor(offset + bit) for every bit set, in increasing order
+    template <typename Visitor>
+    static void forEach(Word word, std::size_t offset, Visitor & visitor)
+    {
+        for(std::size_t bit = 0; word != 0; ++bit, word >>= 1)
+            if(word & Word(1))
+                visitor(offset + bit);
+    }
+};
+
+#if defined(__GNUC__)
+
+template <>
+struct BitsetWordTraits<boost::uint64_t>
+{
+    typedef boost::uint64_t Word;
+
+    static const std::size_t Bits = 64;
+
+    static Word zero() { return 0; }
+    static bool isZero(const Word & word) { return word == 0; }
+    static void set(Word & word, std::size_t bit) { word |= Word(1) << bit; }
+    static void reset(Word & word, std::size_t bit) { word &= ~(Word(1) << bit); }
+    static bool test(const Word & word, std::size_t bit) { return (word >> bit) & Word(1); }
+    static std::size_t lowest(const Word & word) { return __builtin_ctzll(word); }
+
+    template <typename Visitor>
+    static void forEach(Word word, std::size_t offset, Visitor & visitor)
+    {
+        while(word != 0)
+        {
+            visitor(offset + __builtin_ctzll(word));
+            word &= word - 1;
+        }
+    }
+};
+
+// a vector of 64 bit lanes, mapped on SSE (2 lanes) or AVX (4 lanes) registers when available
+template <std::size_t Lanes>
+struct VectorWord
+{
+    typedef boost::uint64_t type __attribute__((vector_size(Lanes * 8)));
+};
+
+typedef VectorWord<2>::type Word128;
+#if defined(__cpp_aligned_new)
+typedef VectorWord<4>::type Word256;
+#endif
+
+template <std::size_t Lanes>
+struct VectorWordTraits
+{
+    typedef typename VectorWord<Lanes>::type Word;
+
+    static const std::size_t Bits = Lanes * 64;
+
+    static Word zero() { Word word = {}; return word; }
+
+    static bool isZero(const Word & word)
+    {
+        boost::uint64_t any = 0;
+        for(std::size_t i = 0; i < Lanes; ++i)
+            any |= word[i];
+        return any == 0;
+    }
+
+    static void set(Word & word, std::size_t bit) { word[bit / 64] |= boost::uint64_t(1) << (bit % 64); }
+    static void reset(Word & word, std::size_t bit) { word[bit / 64] &= ~(boost::uint64_t(1) << (bit % 64)); }
+    static bool test(const Word & word, std::size_t bit) { return (word[bit / 64] >> (bit % 64)) & 1; }
+
+    static std::size_t lowest(const Word & word)
+    {
+        std::size_t lane = 0;
+        while(word[lane] == 0)
+            ++lane;
+        return lane * 64 + __builtin_ctzll(word[lane]);
+    }
+
+    template <typename Visitor>
+    static void forEach(const Word & word, std::size_t offset, Visitor & visitor)
+    {
+        for(std::size_t i = 0; i < Lanes; ++i)
+            BitsetWordTraits<boost::uint64_t>::forEach(word[i], offset + i * 64, visitor);
+    }
+};
+
+template <> struct BitsetWordTraits<Word128> : public VectorWordTraits<2> {};
+#if defined(__cpp_aligned_new)
+template <> struct BitsetWordTraits<Word256> : public VectorWordTraits<4> {};
+#endif
+
+#endif // __GNUC__
+
+} // namespace util
+} // namespace treeDAG
+
+#endif // TREEDAG_UTIL_BITSETWORD_HPP
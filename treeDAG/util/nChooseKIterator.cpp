@@ -15,6 +15,31 @@ void NChooseKProcessor::increment(std::vector<bool> & mask)
     mask.back() = !std::next_permutation(mask.begin(), mask.end() - 1);
 }
 
+void NChooseKProcessor::unrank(std::size_t n, std::size_t k, boost::uint64_t rank, const BinomialTable & binomials, std::vector<bool> & mask)
+{
+    // past the last combination, so at the end
+    if(rank >= binomials(n, k))
+    {
+        mask.back() = true;
+        return;
+    }
+
+    // the masks are visited in lexicographical order, so a leading false is followed by (n-i-1 choose k) masks
+    for(std::size_t i = 0; i < n; ++i)
+    {
+        boost::uint64_t withoutCurrent = binomials(n - i - 1, k);
+
+        if(k == 0 || rank < withoutCurrent)
+            mask[i] = false;
+        else
+        {
+            rank -= withoutCurrent;
+            mask[i] = true;
+            --k;
+        }
+    }
+}
+
 } // util namespace
 } // treeDAG namespace
 
@@ -2,6 +2,7 @@
 #define TREEDAG_UTIL_NCHOOSEKITERATOR_HPP
 
 #include "maskedRangeIterator.hpp"
+#include "binomial.hpp"
 
 
 namespace treeDAG {
@@ -11,6 +12,8 @@ struct NChooseKProcessor
 {
     bool atEnd(const std::vector<bool> & mask) const;
     void increment(std::vector<bool> & mask);
+
+    static void unrank(std::size_t n, std::size_t k, boost::uint64_t rank, const BinomialTable & binomials, std::vector<bool> & mask);
 };
 
 template <typename Iterator>
@@ -22,6 +25,7 @@ public:
     NChooseKIterator();
     NChooseKIterator(Iterator first, Iterator last, std::size_t k);
     NChooseKIterator(Iterator first, std::size_t n, std::size_t k);
+    NChooseKIterator(Iterator first, std::size_t n, std::size_t k, boost::uint64_t rank, const BinomialTable & binomials);
 };
 
 
@@ -31,6 +31,13 @@ CDEF::NChooseKIterator(Iterator first, std::size_t n, std::size_t k)
     std::fill(Base::mask_.begin() + n - k, Base::mask_.begin() + n, true);
 }
 
+TDEF
+CDEF::NChooseKIterator(Iterator first, std::size_t n, std::size_t k, boost::uint64_t rank, const BinomialTable & binomials)
+    : Base(first, n+1, false)
+{
+    Base::unrank(n, k, rank, binomials, Base::mask_);
+}
+
 #undef CDEF
 #undef TDEF
 
@@ -0,0 +1,107 @@
+#include "revolvingDoor.hpp"
+
+namespace treeDAG {
+namespace util {
+
+RevolvingDoorCombination::RevolvingDoorCombination(std::size_t n, std::size_t k)
+    : n_(n),
+      k_(k),
+      c_(k + 1),
+      removed_(0),
+      added_(0),
+      atEnd_(k == 0 || k > n)
+{
+    for(std::size_t j = 0; j < k; ++j)
+        c_[j] = j;
+    c_[k] = n;
+
+    combination_.assign(c_.begin(), c_.begin() + k);
+}
+
+
+bool RevolvingDoorCombination::next()
+{
+    if(atEnd_)
+        return false;
+
+    // the indices below are zero based, so c_[j-1] is c_j in the book
+
+    // R3: the easy case, only c_1 changes
+    std::size_t j;
+    bool increase;
+    if(k_ % 2 == 1)
+    {
+        if(c_[0] + 1 < c_[1])
+        {
+            exchange(0, c_[0] + 1);
+            return true;
+        }
+
+        j = 2;
+        increase = false;
+    }
+    else
+    {
+        if(c_[0] > 0)
+        {
+            exchange(0, c_[0] - 1);
+            return true;
+        }
+
+        j = 2;
+        increase = true;
+    }
+
+    while(j <= k_)
+    {
+        if(!increase)
+        {
+            // R4: try to decrease c_j, here c_j = c_{j-1} + 1
+            if(c_[j - 1] >= j)
+            {
+                removed_ = c_[j - 1];
+                added_ = j - 2;
+                c_[j - 1] = c_[j - 2];
+                c_[j - 2] = j - 2;
+                break;
+            }
+            ++j;
+        }
+        else
+        {
+            // R5: try to increase c_j, here c_{j-1} = j - 2
+            if(c_[j - 1] + 1 < c_[j])
+            {
+                removed_ = j - 2;
+                added_ = c_[j - 1] + 1;
+                c_[j - 2] = c_[j - 1];
+                c_[j - 1] = c_[j - 1] + 1;
+                break;
+            }
+            ++j;
+        }
+
+        increase = !increase;
+    }
+
+    if(j > k_)
+    {
+        atEnd_ = true;
+        return false;
+    }
+
+    combination_.assign(c_.begin(), c_.begin() + k_);
+    return true;
+}
+
+
+void RevolvingDoorCombination::exchange(std::size_t index, std::size_t value)
+{
+    removed_ = c_[index];
+    added_ = value;
+    c_[index] = value;
+    combination_[index] = value;
+}
+
+} // namespace util
+} // namespace treeDAG
@@ -0,0 +1,43 @@
+#ifndef TREEDAG_UTIL_REVOLVINGDOOR_HPP
+#define TREEDAG_UTIL_REVOLVINGDOOR_HPP
+
+#include <vector>
+#include <cstddef>
+
+namespace treeDAG {
+namespace util {
+
+// enumerates all k-subsets of {0, ..., n-1} in revolving door order (Knuth, TAOCP 7.2.1.3,
+// algorithm R): every step removes exactly one element and adds exactly one other element
+class RevolvingDoorCombination
+{
+public:
+    RevolvingDoorCombination(std::size_t n, std::size_t k);
+
+    // the current subset, in increasing order
+    const std::vector<std::size_t> & combination() const { return combination_; }
+
+    // moves to the next subset, returns false if there is none
+    bool next();
+
+    // the element which left and the element which entered in the last call to next()
+    std::size_t removed() const { return removed_; }
+    std::size_t added() const { return added_; }
+
+private:
+    void exchange(std::size_t index, std::size_t value);
+
+    std::size_t n_;
+    std::size_t k_;
+    // c_1 ... c_k, followed by the sentinel c_{k+1} = n
+    std::vector<std::size_t> c_;
+    std::vector<std::size_t> combination_;
+    std::size_t removed_;
+    std::size_t added_;
+    bool atEnd_;
+};
+
+} // namespace util
+} // namespace treeDAG
+
+#endif // TREEDAG_UTIL_REVOLVINGDOOR_HPP
@@ -0,0 +1,174 @@
+#include "vertexOrdering.hpp"
+#include <algorithm>
+
+namespace treeDAG {
+namespace {
+
+struct ByDegree
+{
+    explicit ByDegree(const CSRGraph & graph) : graph(graph) {}
+
+    bool operator()(SeparatorConfig::VertexIndexType lhs, SeparatorConfig::VertexIndexType rhs) const
+    {
+        return graph.degree(lhs) < graph.degree(rhs) || (graph.degree(lhs) == graph.degree(rhs) && lhs < rhs);
+    }
+
+    const CSRGraph & graph;
+};
+
+} // namespace
+
+
+VertexOrdering::VertexOrdering()
+    : graph_(0),
+      method_(ORDER_None)
+{
+}
+
+
+VertexOrdering::VertexOrdering(const CSRGraph * graph, OrderingMethod method)
+    : graph_(graph),
+      method_(method)
+{
+    typedef CSRGraph::AdjacencyIterator adjIt;
+
+    const std::size_t graphSize = graph_->numVertices();
+
+    switch(method_)
+    {
+    case ORDER_None:
+        for(VertexIndexType v = 0; v < graphSize; ++v)
+            originalVertices_.push_back(v);
+        break;
+
+    case ORDER_ReverseCuthillMcKee:
+        orderBreadthFirst(true);
+        std::reverse(originalVertices_.begin(), originalVertices_.end());
+        break;
+
+    case ORDER_BreadthFirst:
+        orderBreadthFirst(false);
+        break;
+
+    case ORDER_Degree:
+        orderByDegree();
+        break;
+    }
+
+    orderedVertices_.resize(graphSize);
+    for(VertexIndexType v = 0; v < graphSize; ++v)
+        orderedVertices_[originalVertices_[v]] = v;
+
+    // and the graph in the new numbering
+    std::vector<std::pair<VertexIndexType, VertexIndexType> > edges;
+    edges.reserve(graph_->numEdges());
+    for(VertexIndexType v = 0; v < graphSize; ++v)
+        for(std::pair<adjIt, adjIt> p = graph_->adjacentVertices(v); p.first != p.second; ++p.first)
+            if(*p.first > v)
+                edges.push_back(std::make_pair(orderedVertices_[v], orderedVertices_[*p.first]));
+
+    ordered_ = CSRGraph::fromEdges(graphSize, edges.begin(), edges.end());
+}
+
+
+void VertexOrdering::lift(DecompositionDAG & dag, const SeparatorCache & cache) const
+{
+    dag.relabel(originalVertices_, &cache);
+}
+
+
+void VertexOrdering::orderBreadthFirst(bool cuthillMcKee)
+{
+    const std::size_t graphSize = graph_->numVertices();
+    std::vector<bool> numbered(graphSize, false);
+
+    originalVertices_.clear();
+    originalVertices_.reserve(graphSize);
+
+    std::size_t lastLevel;
+    for(VertexIndexType v = 0; v < graphSize; ++v)
+        if(!numbered[v])
+            breadthFirst(cuthillMcKee ? peripheralVertex(v, numbered) : v, cuthillMcKee, numbered, originalVertices_, lastLevel);
+}
+
+
+void VertexOrdering::orderByDegree()
+{
+    const std::size_t graphSize = graph_->numVertices();
+
+    originalVertices_.clear();
+    for(VertexIndexType v = 0; v < graphSize; ++v)
+        originalVertices_.push_back(v);
+
+    std::sort(originalVertices_.begin(), originalVertices_.end(), ByDegree(*graph_));
+}
+
+
+SeparatorConfig::VertexIndexType VertexOrdering::peripheralVertex(VertexIndexType start, std::vector<bool> & numbered) const
+{
+    // George and Liu: move to a vertex of the lowest degree in the last level, as long as the depth grows
+    VertexSet order;
+    std::size_t lastLevel = 0;
+    VertexIndexType current = start;
+    std::size_t depth = breadthFirst(current, false, numbered, order, lastLevel);
+
+    while(true)
+    {
+        for(VertexSet::const_iterator it = order.begin(); it != order.end(); ++it)
+            numbered[*it] = false;
+
+        const VertexIndexType candidate = *std::min_element(order.begin() + lastLevel, order.end(), ByDegree(*graph_));
+
+        order.clear();
+        const std::size_t candidateDepth = breadthFirst(candidate, false, numbered, order, lastLevel);
+        if(candidateDepth <= depth)
+        {
+            for(VertexSet::const_iterator it = order.begin(); it != order.end(); ++it)
+                numbered[*it] = false;
+            return current;
+        }
+
+        current = candidate;
+        depth = candidateDepth;
+    }
+}
+
+
+std::size_t VertexOrdering::breadthFirst(VertexIndexType start, bool byDegree, std::vector<bool> & numbered, VertexSet & order, std::size_t & lastLevel) const
+{
+    typedef CSRGraph::AdjacencyIterator adjIt;
+
+    // appends the component of the start to the order, and returns the depth of the search
+    const std::size_t first = order.size();
+    lastLevel = first;
+    order.push_back(start);
+    numbered[start] = true;
+
+    std::size_t depth = 0;
+    std::size_t levelEnd = order.size();
+
+    for(std::size_t i = first; i < order.size(); ++i)
+    {
+        if(i == levelEnd)
+        {
+            ++depth;
+            lastLevel = i;
+            levelEnd = order.size();
+        }
+
+        const std::size_t next = order.size();
+        for(std::pair<adjIt, adjIt> p = graph_->adjacentVertices(order[i]); p.first != p.second; ++p.first)
+            if(!numbered[*p.first])
+            {
+                numbered[*p.first] = true;
+                order.push_back(*p.first);
+            }
+
+        if(byDegree)
+            std::sort(order.begin() + next, order.end(), ByDegree(*graph_));
+    }
+
+    return depth;
+}
+
+} // namespace treeDAG
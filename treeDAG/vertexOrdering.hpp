@@ -0,0 +1,55 @@
+#ifndef TREEDAG_VERTEXORDERING_HPP
+#define TREEDAG_VERTEXORDERING_HPP
+
+#include "separatorConfig.hpp"
+#include "csrGraph.hpp"
+#include "decompositionDAG.hpp"
+
+namespace treeDAG {
+
+// renumbers the vertices of a graph so neighbours get nearby numbers, which keeps the searches of the
+// separators, the vertex indexed arrays and the subset enumeration in fewer cache lines. The dags of
+// the ordered graph are translated back with lift()
+class VertexOrdering : public SeparatorConfig
+{
+public:
+    enum OrderingMethod
+    {
+        ORDER_None,
+        // breadth first from a pseudo peripheral vertex per component, the neighbours by increasing degree, reversed
+        ORDER_ReverseCuthillMcKee,
+        // breadth first from the lowest numbered vertex per component
+        ORDER_BreadthFirst,
+        // by increasing degree
+        ORDER_Degree
+    };
+
+    VertexOrdering();
+    VertexOrdering(const CSRGraph * graph, OrderingMethod method);
+
+    OrderingMethod orderingMethod() const { return method_; }
+    const CSRGraph & orderedGraph() const { return ordered_; }
+
+    VertexIndexType orderedVertex(VertexIndexType originalVertex) const { return orderedVertices_[originalVertex]; }
+    VertexIndexType originalVertex(VertexIndexType orderedVertex) const { return originalVertices_[orderedVertex]; }
+
+    // the dag of the ordered graph in the original numbering, the cache holds the separations of the
+    // ordered graph and renumbers the inactive components
+    void lift(DecompositionDAG & dag, const SeparatorCache & cache) const;
+
+private:
+    void orderBreadthFirst(bool cuthillMcKee);
+    void orderByDegree();
+    VertexIndexType peripheralVertex(VertexIndexType start, std::vector<bool> & numbered) const;
+    std::size_t breadthFirst(VertexIndexType start, bool byDegree, std::vector<bool> & numbered, VertexSet & order, std::size_t & lastLevel) const;
+
+    const CSRGraph * graph_;
+    OrderingMethod method_;
+    CSRGraph ordered_;
+    VertexSet orderedVertices_;
+    VertexSet originalVertices_;
+};
+
+} // namespace treeDAG
+
+#endif // TREEDAG_VERTEXORDERING_HPP